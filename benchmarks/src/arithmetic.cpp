@@ -0,0 +1,89 @@
+#include <benchmark/benchmark.h>
+#include "z_module.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// These benchmarks are built twice, with and without FGS_STATS_SUPPORT
+// (z_module_bench and z_module_bench_stats), to measure the cost of the
+// operation counters. Without the macro the hooks must vanish completely.
+namespace{
+    template <auto N>
+    std::vector<fgs::Z<N>> random_elements(std::size_t n){
+        std::vector<fgs::Z<N>> v(n);
+        std::uint64_t x = 0xA4093822299F31D0ull;
+        for (auto &e : v){
+            x = x*6364136223846793005ull + 1442695040888963407ull;
+            e = fgs::Z<N>{x >> 11};
+        }
+        return v;
+    }
+
+    // Multiply-accumulate chain: add, mul and the constructors
+    template <auto N>
+    void BM_dot_product(benchmark::State &state){
+        const auto a = random_elements<N>(static_cast<std::size_t>(state.range(0)));
+        const auto b = random_elements<N>(static_cast<std::size_t>(state.range(0)));
+
+        for (auto _ : state){
+            fgs::Z<N> acc{0u};
+            for (std::size_t i=0; i<a.size(); ++i)
+                acc += a[i]*b[i];
+            benchmark::DoNotOptimize(acc);
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+
+    template <auto N>
+    void BM_pow(benchmark::State &state){
+        const auto a = random_elements<N>(1024);
+        for (auto _ : state)
+            for (const auto &e : a)
+                benchmark::DoNotOptimize(e ^ (N-2));
+        state.SetItemsProcessed(state.iterations() * 1024);
+    }
+
+    template <auto N>
+    void BM_inverse(benchmark::State &state){
+        const auto a = random_elements<N>(1024);
+        for (auto _ : state)
+            for (const auto &e : a)
+                benchmark::DoNotOptimize(fgs::Z<N>{1u} / e);
+        state.SetItemsProcessed(state.iterations() * 1024);
+    }
+
+    template <auto N>
+    void BM_parse(benchmark::State &state){
+        const std::string s(static_cast<std::size_t>(state.range(0)), '7');
+        for (auto _ : state)
+            benchmark::DoNotOptimize(fgs::Z<N>{s});
+        state.SetBytesProcessed(state.iterations() * state.range(0));
+    }
+
+    // Scan loop comparing against plain integers, which are usually already
+    // reduced and shouldn't pay a reduction per comparison
+    template <auto N>
+    void BM_mixed_filter(benchmark::State &state){
+        const auto a = random_elements<N>(static_cast<std::size_t>(state.range(0)));
+        std::vector<std::int64_t> keys(a.size());
+        for (std::size_t i=0; i<keys.size(); ++i)
+            keys[i] = static_cast<std::int64_t>((i*7919) % 1000003);
+
+        for (auto _ : state){
+            std::size_t hits = 0;
+            for (std::size_t i=0; i<a.size(); ++i)
+                hits += (a[i] == keys[i]);
+            benchmark::DoNotOptimize(hits);
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+
+    constexpr auto prime = 998244353u;
+}
+
+BENCHMARK_TEMPLATE(BM_dot_product, prime)->Range(1<<10, 1<<20);
+BENCHMARK_TEMPLATE(BM_pow, prime);
+BENCHMARK_TEMPLATE(BM_inverse, prime);
+BENCHMARK_TEMPLATE(BM_parse, prime)->Range(16, 1<<12);
+BENCHMARK_TEMPLATE(BM_mixed_filter, prime)->Range(1<<10, 1<<20);
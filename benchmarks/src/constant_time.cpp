@@ -0,0 +1,87 @@
+#include <benchmark/benchmark.h>
+#include "z_module.hpp"
+#include "z_module_constant_time.hpp"
+
+#include <cstdint>
+#include <vector>
+
+// The same kernels for the fast z-modules (Z) and the constant-time ones
+// (Z_ct), to measure the price of the constant-time guarantees
+namespace{
+    template <typename T>
+    std::vector<T> random_elements(std::size_t n, std::uint64_t seed){
+        std::vector<T> v(n);
+        for (auto &e : v){
+            seed = seed*6364136223846793005ull + 1442695040888963407ull;
+            e = T{seed >> 11};
+        }
+        return v;
+    }
+
+    // Multiply-accumulate chain
+    template <typename T>
+    void BM_dot_product(benchmark::State &state){
+        const auto a = random_elements<T>(static_cast<std::size_t>(state.range(0)), 1);
+        const auto b = random_elements<T>(static_cast<std::size_t>(state.range(0)), 2);
+
+        for (auto _ : state){
+            T acc{0u};
+            for (std::size_t i=0; i<a.size(); ++i)
+                acc += a[i]*b[i];
+            benchmark::DoNotOptimize(acc);
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+
+    // Additions and subtractions only, the masks against the branches
+    template <typename T>
+    void BM_add_sub(benchmark::State &state){
+        const auto a = random_elements<T>(static_cast<std::size_t>(state.range(0)), 1);
+
+        for (auto _ : state){
+            T acc{0u}, alt{0u};
+            for (const auto &e : a){
+                acc += e;
+                alt -= acc;
+            }
+            benchmark::DoNotOptimize(alt);
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+
+    template <typename T>
+    void BM_pow(benchmark::State &state){
+        const auto a = random_elements<T>(1024, 1);
+        for (auto _ : state)
+            for (const auto &e : a)
+                benchmark::DoNotOptimize(e ^ (T::N-2));
+        state.SetItemsProcessed(state.iterations() * 1024);
+    }
+
+    template <typename T>
+    void BM_inverse(benchmark::State &state){
+        const auto a = random_elements<T>(1024, 1);
+        for (auto _ : state)
+            for (const auto &e : a)
+                benchmark::DoNotOptimize(T{1u} / e);
+        state.SetItemsProcessed(state.iterations() * 1024);
+    }
+
+    constexpr auto prime = 998244353u;
+    constexpr auto big = 18446744073709551557ull;  // 2^64 - 59
+}
+
+BENCHMARK_TEMPLATE(BM_dot_product, fgs::Z<prime>)->Arg(1<<16);
+BENCHMARK_TEMPLATE(BM_dot_product, fgs::Z_ct<prime>)->Arg(1<<16);
+BENCHMARK_TEMPLATE(BM_dot_product, fgs::Z<big>)->Arg(1<<16);
+BENCHMARK_TEMPLATE(BM_dot_product, fgs::Z_ct<big>)->Arg(1<<16);
+BENCHMARK_TEMPLATE(BM_add_sub, fgs::Z<prime>)->Arg(1<<16);
+BENCHMARK_TEMPLATE(BM_add_sub, fgs::Z_ct<prime>)->Arg(1<<16);
+BENCHMARK_TEMPLATE(BM_pow, fgs::Z<prime>);
+BENCHMARK_TEMPLATE(BM_pow, fgs::Z_ct<prime>);
+BENCHMARK_TEMPLATE(BM_pow, fgs::Z<big>);
+BENCHMARK_TEMPLATE(BM_pow, fgs::Z_ct<big>);
+BENCHMARK_TEMPLATE(BM_inverse, fgs::Z<prime>);
+BENCHMARK_TEMPLATE(BM_inverse, fgs::Z_ct<prime>);
+BENCHMARK_TEMPLATE(BM_inverse, fgs::Z<big>);
+BENCHMARK_TEMPLATE(BM_inverse, fgs::Z_ct<big>);
@@ -0,0 +1,70 @@
+#include <benchmark/benchmark.h>
+#include "z_module.hpp"
+#include "z_module_bulk.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace{
+    template <typename T>
+    std::vector<T> random_input(std::size_t n){
+        std::vector<T> v(n);
+        std::uint64_t x = 0x452821E638D01377ull;
+        for (auto &e : v){
+            x = x*6364136223846793005ull + 1442695040888963407ull;
+            e = static_cast<T>(x >> 3);
+        }
+        return v;
+    }
+
+    // Baseline: one constructor call per element
+    template <auto N, typename T>
+    void BM_constructor_loop(benchmark::State &state){
+        const auto in = random_input<T>(static_cast<std::size_t>(state.range(0)));
+        std::vector<fgs::Z<N>> out(in.size());
+
+        for (auto _ : state){
+            for (std::size_t i=0; i<in.size(); ++i)
+                out[i] = fgs::Z<N>{in[i]};
+            benchmark::DoNotOptimize(out.data());
+            benchmark::ClobberMemory();
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+
+    template <auto N, typename T>
+    void BM_reduce_into(benchmark::State &state){
+        const auto in = random_input<T>(static_cast<std::size_t>(state.range(0)));
+        std::vector<fgs::Z<N>> out(in.size());
+
+        for (auto _ : state){
+            fgs::reduce_into(in, out);
+            benchmark::DoNotOptimize(out.data());
+            benchmark::ClobberMemory();
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+
+    template <auto N, typename T>
+    void BM_lift_from(benchmark::State &state){
+        const auto in = random_input<T>(static_cast<std::size_t>(state.range(0)));
+        std::vector<fgs::Z<N>> zm(in.size());
+        std::vector<T> out(in.size());
+        fgs::reduce_into(in, zm);
+
+        for (auto _ : state){
+            fgs::lift_from(zm, out);
+            benchmark::DoNotOptimize(out.data());
+            benchmark::ClobberMemory();
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+}
+
+BENCHMARK_TEMPLATE(BM_constructor_loop, 998244353u, std::int64_t)->Range(1<<10, 1<<24);
+BENCHMARK_TEMPLATE(BM_reduce_into,      998244353u, std::int64_t)->Range(1<<10, 1<<24);
+BENCHMARK_TEMPLATE(BM_constructor_loop, 998244353u, std::int32_t)->Range(1<<10, 1<<24);
+BENCHMARK_TEMPLATE(BM_reduce_into,      998244353u, std::int32_t)->Range(1<<10, 1<<24);
+BENCHMARK_TEMPLATE(BM_constructor_loop, 998244353u, std::uint32_t)->Range(1<<10, 1<<24);
+BENCHMARK_TEMPLATE(BM_reduce_into,      998244353u, std::uint32_t)->Range(1<<10, 1<<24);
+BENCHMARK_TEMPLATE(BM_lift_from,        998244353u, std::int64_t)->Range(1<<10, 1<<24);
@@ -0,0 +1,94 @@
+#include <benchmark/benchmark.h>
+#include "z_module.hpp"
+#include "z_module_crt.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace{
+    // 2^4 * 3^2 * 1000003 * (2^31-1), about 2^58
+    constexpr auto composite = 16ull * 9ull * 1000003ull * 2147483647ull;
+    using crt = fgs::crt_view<composite>;
+
+    std::vector<fgs::Z<composite>> random_units(std::size_t n){
+        std::vector<fgs::Z<composite>> v(n);
+        std::uint64_t x = 0xA4093822299F31D0ull;
+        for (auto &e : v){
+            do{
+                x = x*6364136223846793005ull + 1442695040888963407ull;
+                e = fgs::Z<composite>{x >> 6};
+            } while (!crt::is_unit(e));
+        }
+        return v;
+    }
+
+    // Element-wise products at full width
+    void BM_full_width_multiply(benchmark::State &state){
+        auto a = random_units(static_cast<std::size_t>(state.range(0)));
+        const auto b = random_units(static_cast<std::size_t>(state.range(0)));
+
+        for (auto _ : state){
+            for (std::size_t i=0; i<a.size(); ++i)
+                a[i] *= b[i];
+            benchmark::DoNotOptimize(a.data());
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+
+    // Same products, one narrow component per thread
+    void BM_crt_multiply(benchmark::State &state){
+        crt::vector a(random_units(static_cast<std::size_t>(state.range(0))));
+        const crt::vector b(random_units(static_cast<std::size_t>(state.range(0))));
+
+        for (auto _ : state){
+            a *= b;
+            benchmark::DoNotOptimize(&a);
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+
+    // Round trip between both forms
+    void BM_crt_convert(benchmark::State &state){
+        const auto a = random_units(static_cast<std::size_t>(state.range(0)));
+        std::vector<fgs::Z<composite>> out(a.size());
+
+        for (auto _ : state){
+            crt::vector(a).recombine(out);
+            benchmark::DoNotOptimize(out.data());
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+
+    void BM_full_width_inverse(benchmark::State &state){
+        const auto a = random_units(1024);
+        for (auto _ : state)
+            for (const auto &e : a)
+                benchmark::DoNotOptimize(fgs::Z<composite>{1u} / e);
+        state.SetItemsProcessed(state.iterations() * 1024);
+    }
+
+    void BM_crt_inverse(benchmark::State &state){
+        const auto a = random_units(1024);
+        for (auto _ : state)
+            for (const auto &e : a)
+                benchmark::DoNotOptimize(crt::inverse(e));
+        state.SetItemsProcessed(state.iterations() * 1024);
+    }
+
+    // Montgomery's trick in every component
+    void BM_crt_batch_inverse(benchmark::State &state){
+        crt::vector a(random_units(static_cast<std::size_t>(state.range(0))));
+        for (auto _ : state){
+            a.invert();
+            benchmark::DoNotOptimize(&a);
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+}
+
+BENCHMARK(BM_full_width_multiply)->Range(1<<10, 1<<22);
+BENCHMARK(BM_crt_multiply)->Range(1<<10, 1<<22)->UseRealTime();
+BENCHMARK(BM_crt_convert)->Range(1<<10, 1<<22)->UseRealTime();
+BENCHMARK(BM_full_width_inverse);
+BENCHMARK(BM_crt_inverse);
+BENCHMARK(BM_crt_batch_inverse)->Range(1<<10, 1<<22)->UseRealTime();
@@ -0,0 +1,168 @@
+// Timing leakage detection in the style of dudect ("Dude, is my code constant
+// time?", Reparaz, Balasch and Verbauwhede). Every operation is timed over
+// two classes of inputs, a fixed value and random values, interleaved at
+// random so both classes see the same noise, and Welch's t-test checks
+// whether both distributions of times have the same mean. The test is also
+// repeated after cropping the slowest measurements at several percentiles,
+// since a leak often hides in the tail of the distribution.
+//
+// |t| above 10 is a clear leak and above 4.5 a likely one. The fast z-modules
+// are measured as well, as a control that the harness does detect leaks.
+//
+// Usage: z_module_dudect [measurements per test]
+#include "z_module.hpp"
+#include "z_module_constant_time.hpp"
+#include "z_module_random.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+namespace{
+    // Keeps the compiler from hoisting the operation out of the timing loop
+    template <typename T>
+    inline void clobber(T &x){
+        asm volatile("" : "+m"(x) : : "memory");
+    }
+
+    // Welch's t statistic, accumulated online (Welford's algorithm)
+    class welch_test{
+    public:
+        void push(double x, int c){
+            ++n[c];
+            const double delta = x - mean[c];
+            mean[c] += delta / n[c];
+            m2[c] += delta * (x - mean[c]);
+        }
+
+        double t() const {
+            if (n[0] < 2 || n[1] < 2)
+                return 0;
+            const double var0 = m2[0] / (n[0]-1), var1 = m2[1] / (n[1]-1);
+            const double den = std::sqrt(var0/n[0] + var1/n[1]);
+            return (den == 0) ? 0 : (mean[0] - mean[1]) / den;
+        }
+
+    private:
+        std::array<double, 2> n{}, mean{}, m2{};
+    };
+
+    struct result{
+        double max_t;
+        double mean_ns;
+    };
+
+    // Times op(input) `reps` times per measurement. prepare(c, rng) gives an
+    // input of class c, and all of them are built before the clock starts
+    template <typename Prepare, typename Op>
+    result measure(std::size_t measurements, int reps, Prepare prepare, Op op){
+        fgs::counter_engine rng(42);
+        std::vector<int> classes(measurements);
+        using input_type = decltype(prepare(0, rng));
+        std::vector<input_type> inputs;
+        inputs.reserve(measurements);
+        for (auto &c : classes){
+            c = static_cast<int>(rng() & 1);
+            inputs.push_back(prepare(c, rng));
+        }
+
+        std::vector<double> times(measurements);
+        for (std::size_t i=0; i<measurements; ++i){
+            auto x = inputs[i];
+            const auto start = std::chrono::steady_clock::now();
+            for (int r=0; r<reps; ++r){
+                clobber(x);
+                auto y = op(x);
+                clobber(y);
+            }
+            const auto stop = std::chrono::steady_clock::now();
+            times[i] = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start).count());
+        }
+
+        // Raw test plus cropped ones, thresholds 1 - 0.5^(10(k+1)/crops) as in dudect
+        constexpr int crops = 10;
+        std::vector<double> sorted = times;
+        std::sort(sorted.begin(), sorted.end());
+        std::array<double, crops> thresholds;
+        for (int k=0; k<crops; ++k){
+            const double p = 1 - std::pow(0.5, 10.0*(k+1)/crops);
+            thresholds[k] = sorted[static_cast<std::size_t>(p * static_cast<double>(measurements-1))];
+        }
+
+        welch_test raw;
+        std::array<welch_test, crops> cropped;
+        double total = 0;
+        for (std::size_t i=0; i<measurements; ++i){
+            raw.push(times[i], classes[i]);
+            for (int k=0; k<crops; ++k)
+                if (times[i] <= thresholds[k])
+                    cropped[k].push(times[i], classes[i]);
+            total += times[i];
+        }
+
+        double max_t = std::abs(raw.t());
+        for (const auto &w : cropped)
+            max_t = std::max(max_t, std::abs(w.t()));
+        return {max_t, total / static_cast<double>(measurements) / reps};
+    }
+
+    const char* verdict(double t){
+        return (t > 10) ? "leak" : (t > 4.5) ? "probable leak" : "no leak detected";
+    }
+
+    constexpr auto N = 18446744073709551557ull;    // 2^64 - 59
+    using zm_t = fgs::Z<N>;
+    using ct_t = fgs::Z_ct<N>;
+
+    // Random element for class 1, `fixed` for class 0
+    template <typename T>
+    auto fixed_or_random(std::uint64_t fixed){
+        return [fixed](int c, fgs::counter_engine &rng){
+            return T{c == 0 ? fixed : rng()};
+        };
+    }
+}
+
+int main(int argc, char *argv[]){
+    const std::size_t measurements = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : 200000;
+    bool constant_time_leaks = false;
+
+    const auto report = [&](const char *name, bool constant_time, const result &r){
+        std::printf("%-28s %10.1f ns   max |t| = %7.2f   %s\n", name, r.mean_ns, r.max_t, verdict(r.max_t));
+        if (constant_time && r.max_t > 10)
+            constant_time_leaks = true;
+    };
+
+    // Decrement: 0 wraps around
+    report("Z    --x (x = 0)", false, measure(measurements, 64, fixed_or_random<zm_t>(0),
+        [](zm_t x){ return --x; }));
+    report("Z_ct --x (x = 0)", true, measure(measurements, 64, fixed_or_random<ct_t>(0),
+        [](ct_t x){ return --x; }));
+
+    // Multiplication: x = 0
+    report("Z    x*x (x = 0)", false, measure(measurements, 64, fixed_or_random<zm_t>(0),
+        [](zm_t x){ return x*x; }));
+    report("Z_ct x*x (x = 0)", true, measure(measurements, 64, fixed_or_random<ct_t>(0),
+        [](ct_t x){ return x*x; }));
+
+    // Power with a secret exponent, e = 1 against random ones
+    const auto exponent = [](int c, fgs::counter_engine &rng){ return c == 0 ? std::uint64_t(1) : rng(); };
+    report("Z    3^e (e = 1)", false, measure(measurements, 4, exponent,
+        [](std::uint64_t e){ return zm_t(3u) ^ e; }));
+    report("Z_ct 3^e (e = 1)", true, measure(measurements, 4, exponent,
+        [](std::uint64_t e){ return ct_t(3u) ^ e; }));
+
+    // Inverse: x = 1
+    report("Z    1/x (x = 1)", false, measure(measurements, 4, fixed_or_random<zm_t>(1),
+        [](zm_t x){ return zm_t(1u) / x; }));
+    report("Z_ct 1/x (x = 1)", true, measure(measurements, 4, fixed_or_random<ct_t>(1),
+        [](ct_t x){ return x.inverse(); }));
+
+    return constant_time_leaks ? EXIT_FAILURE : EXIT_SUCCESS;
+}
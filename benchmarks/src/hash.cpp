@@ -0,0 +1,43 @@
+#include <benchmark/benchmark.h>
+#include "z_module.hpp"
+#include "z_module_rolling_hash.hpp"
+
+#include <cstdint>
+#include <string>
+
+namespace{
+    std::string random_text(std::size_t n, std::uint64_t seed){
+        std::string s(n, ' ');
+        for (auto &c : s){
+            seed = seed*6364136223846793005ull + 1442695040888963407ull;
+            c = static_cast<char>('a' + (seed >> 59));
+        }
+        return s;
+    }
+
+    // Prefix hashes and base powers of a text
+    template <auto N>
+    void BM_rolling_hash_build(benchmark::State &state){
+        const auto text = random_text(static_cast<std::size_t>(state.range(0)), 1);
+
+        for (auto _ : state)
+            benchmark::DoNotOptimize(fgs::rolling_hash<N, 131>(text).hash());
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+
+    // Double hashing, the usual defence against collisions
+    void BM_double_rolling_hash_build(benchmark::State &state){
+        const auto text = random_text(static_cast<std::size_t>(state.range(0)), 1);
+
+        for (auto _ : state)
+            benchmark::DoNotOptimize(fgs::double_rolling_hash<1000000007u, 131, 998244353u, 137>(text).hash());
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+
+    constexpr auto mersenne = (1ull << 61) - 1;
+    constexpr auto prime = 1000000007u;
+}
+
+BENCHMARK_TEMPLATE(BM_rolling_hash_build, mersenne)->RangeMultiplier(16)->Range(1<<12, 1<<24)->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_rolling_hash_build, prime)->RangeMultiplier(16)->Range(1<<12, 1<<24)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_double_rolling_hash_build)->RangeMultiplier(16)->Range(1<<12, 1<<24)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,104 @@
+#include <benchmark/benchmark.h>
+#include "z_module.hpp"
+#include "z_module_polynomial.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace{
+    template <auto P>
+    fgs::polynomial<P> random_polynomial(std::size_t n, std::uint64_t seed){
+        std::vector<fgs::Z<P>> v(n);
+        for (auto &e : v){
+            seed = seed*6364136223846793005ull + 1442695040888963407ull;
+            e = fgs::Z<P>{seed >> 11};
+        }
+        v.back() = fgs::Z<P>{1u};
+        return fgs::polynomial<P>(std::move(v));
+    }
+
+    template <auto P>
+    void BM_multiply(benchmark::State &state){
+        const auto n = static_cast<std::size_t>(state.range(0));
+        const auto a = random_polynomial<P>(n, 1), b = random_polynomial<P>(n, 2);
+
+        for (auto _ : state)
+            benchmark::DoNotOptimize(a*b);
+        state.SetComplexityN(state.range(0));
+    }
+
+    template <auto P>
+    void BM_inverse_series(benchmark::State &state){
+        const auto n = static_cast<std::size_t>(state.range(0));
+        const auto a = random_polynomial<P>(n, 3);
+
+        for (auto _ : state)
+            benchmark::DoNotOptimize(a.inverse_series(n));
+        state.SetComplexityN(state.range(0));
+    }
+
+    // Degree 2n by degree n
+    template <auto P>
+    void BM_divmod(benchmark::State &state){
+        const auto n = static_cast<std::size_t>(state.range(0));
+        const auto a = random_polynomial<P>(2*n, 4), b = random_polynomial<P>(n, 5);
+
+        for (auto _ : state)
+            benchmark::DoNotOptimize(divmod(a, b));
+        state.SetComplexityN(state.range(0));
+    }
+
+    // Degree n polynomial at n points
+    template <auto P>
+    void BM_multipoint_evaluation(benchmark::State &state){
+        const auto n = static_cast<std::size_t>(state.range(0));
+        const auto a = random_polynomial<P>(n, 6);
+        const auto points = random_polynomial<P>(n, 7).coefficients();
+
+        for (auto _ : state)
+            benchmark::DoNotOptimize(a.evaluate(points));
+        state.SetComplexityN(state.range(0));
+    }
+
+    // Baseline for multipoint evaluation: Horner at every point
+    template <auto P>
+    void BM_horner_evaluation(benchmark::State &state){
+        const auto n = static_cast<std::size_t>(state.range(0));
+        const auto a = random_polynomial<P>(n, 6);
+        const auto points = random_polynomial<P>(n, 7).coefficients();
+
+        for (auto _ : state)
+            for (const auto &x : points)
+                benchmark::DoNotOptimize(a(x));
+        state.SetComplexityN(state.range(0));
+    }
+
+    template <auto P>
+    void BM_interpolation(benchmark::State &state){
+        const auto n = static_cast<std::size_t>(state.range(0));
+        const auto xs = random_polynomial<P>(n, 8).coefficients();
+        const auto ys = random_polynomial<P>(n, 9).coefficients();
+
+        for (auto _ : state)
+            benchmark::DoNotOptimize(fgs::polynomial<P>::interpolate(xs, ys));
+        state.SetComplexityN(state.range(0));
+    }
+
+    constexpr auto ntt_prime = 998244353u;
+    constexpr auto other_prime = 1000000007u;
+}
+
+BENCHMARK_TEMPLATE(BM_multiply, ntt_prime)->RangeMultiplier(4)->Range(1<<4, 1<<20)
+    ->Unit(benchmark::kMicrosecond)->Complexity();
+BENCHMARK_TEMPLATE(BM_multiply, other_prime)->RangeMultiplier(4)->Range(1<<4, 1<<20)
+    ->Unit(benchmark::kMicrosecond)->Complexity();
+BENCHMARK_TEMPLATE(BM_inverse_series, ntt_prime)->RangeMultiplier(4)->Range(1<<4, 1<<20)
+    ->Unit(benchmark::kMicrosecond)->Complexity();
+BENCHMARK_TEMPLATE(BM_divmod, ntt_prime)->RangeMultiplier(4)->Range(1<<4, 1<<20)
+    ->Unit(benchmark::kMicrosecond)->Complexity();
+BENCHMARK_TEMPLATE(BM_multipoint_evaluation, ntt_prime)->RangeMultiplier(4)->Range(1<<4, 1<<20)
+    ->Unit(benchmark::kMillisecond)->Complexity();
+BENCHMARK_TEMPLATE(BM_horner_evaluation, ntt_prime)->RangeMultiplier(4)->Range(1<<4, 1<<16)
+    ->Unit(benchmark::kMillisecond)->Complexity();
+BENCHMARK_TEMPLATE(BM_interpolation, ntt_prime)->RangeMultiplier(4)->Range(1<<4, 1<<20)
+    ->Unit(benchmark::kMillisecond)->Complexity();
@@ -0,0 +1,63 @@
+#include <benchmark/benchmark.h>
+#include "z_module.hpp"
+#include "z_module_random.hpp"
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace{
+    // The biased construction from a raw word, with a % per sample
+    template <auto N>
+    void BM_construct_from_engine(benchmark::State &state){
+        std::vector<fgs::Z<N>> out(static_cast<std::size_t>(state.range(0)));
+        std::mt19937_64 g(1);
+
+        for (auto _ : state){
+            for (auto &e : out)
+                e = fgs::Z<N>(g());
+            benchmark::DoNotOptimize(out.data());
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+
+    template <auto N, typename Engine>
+    void BM_distribution(benchmark::State &state){
+        std::vector<fgs::Z<N>> out(static_cast<std::size_t>(state.range(0)));
+        fgs::uniform_zmodule_distribution<N> dist;
+        Engine g(1);
+
+        for (auto _ : state){
+            for (auto &e : out)
+                e = dist(g);
+            benchmark::DoNotOptimize(out.data());
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+
+    // Blocks of counter-based words
+    template <auto N>
+    void BM_distribution_generate(benchmark::State &state){
+        std::vector<fgs::Z<N>> out(static_cast<std::size_t>(state.range(0)));
+        fgs::uniform_zmodule_distribution<N> dist;
+        fgs::counter_engine g(1);
+
+        for (auto _ : state){
+            dist.generate(out, g);
+            benchmark::DoNotOptimize(out.data());
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+
+    constexpr auto prime = 998244353u;
+    constexpr auto big = 18446744073709551557ull;
+}
+
+BENCHMARK_TEMPLATE(BM_construct_from_engine, prime)->Arg(1<<16);
+BENCHMARK_TEMPLATE(BM_distribution, prime, std::mt19937_64)->Arg(1<<16);
+BENCHMARK_TEMPLATE(BM_distribution, prime, fgs::counter_engine)->Arg(1<<16);
+BENCHMARK_TEMPLATE(BM_distribution_generate, prime)->Arg(1<<16);
+BENCHMARK_TEMPLATE(BM_construct_from_engine, big)->Arg(1<<16);
+BENCHMARK_TEMPLATE(BM_distribution, big, std::mt19937_64)->Arg(1<<16);
+BENCHMARK_TEMPLATE(BM_distribution, big, fgs::counter_engine)->Arg(1<<16);
+BENCHMARK_TEMPLATE(BM_distribution_generate, big)->Arg(1<<16);
@@ -0,0 +1,98 @@
+#include <benchmark/benchmark.h>
+#include "z_module.hpp"
+#include "z_module_sequences.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace{
+    template <auto N>
+    std::vector<fgs::Z<N>> random_elements(std::size_t n, std::uint64_t seed){
+        std::vector<fgs::Z<N>> v(n);
+        for (auto &e : v){
+            seed = seed*6364136223846793005ull + 1442695040888963407ull;
+            e = fgs::Z<N>{seed >> 11};
+        }
+        return v;
+    }
+
+    // One multiplication chain
+    template <auto N>
+    void BM_powers_next(benchmark::State &state){
+        std::vector<fgs::Z<N>> out(static_cast<std::size_t>(state.range(0)));
+        auto p = fgs::powers(fgs::Z<N>{3u});
+
+        for (auto _ : state){
+            for (auto &e : out)
+                e = p.next();
+            benchmark::DoNotOptimize(out.data());
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+
+    // Independent chains
+    template <auto N>
+    void BM_powers_next_n(benchmark::State &state){
+        std::vector<fgs::Z<N>> out(static_cast<std::size_t>(state.range(0)));
+        auto p = fgs::powers(fgs::Z<N>{3u});
+
+        for (auto _ : state){
+            p.next_n(out);
+            benchmark::DoNotOptimize(out.data());
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+
+    // One term at a time, against the batch of next_n
+    template <auto N>
+    void BM_recurrence_next(benchmark::State &state){
+        const auto k = static_cast<std::size_t>(state.range(0));
+        fgs::linear_recurrence rec(random_elements<N>(k, 1), random_elements<N>(k, 2));
+        std::vector<fgs::Z<N>> out(1 << 12);
+
+        for (auto _ : state){
+            for (auto &e : out)
+                e = rec.next();
+            benchmark::DoNotOptimize(out.data());
+        }
+        state.SetItemsProcessed(state.iterations() * (1 << 12));
+    }
+
+    template <auto N>
+    void BM_recurrence_next_n(benchmark::State &state){
+        const auto k = static_cast<std::size_t>(state.range(0));
+        fgs::linear_recurrence rec(random_elements<N>(k, 1), random_elements<N>(k, 2));
+        std::vector<fgs::Z<N>> out(1 << 12);
+
+        for (auto _ : state){
+            rec.next_n(out);
+            benchmark::DoNotOptimize(out.data());
+        }
+        state.SetItemsProcessed(state.iterations() * (1 << 12));
+    }
+
+    // Jump to a term far away, for growing orders
+    template <auto N>
+    void BM_recurrence_nth(benchmark::State &state){
+        const auto k = static_cast<std::size_t>(state.range(0));
+        const fgs::linear_recurrence rec(random_elements<N>(k, 1), random_elements<N>(k, 2));
+
+        for (auto _ : state)
+            benchmark::DoNotOptimize(rec.nth(1000000000000000000ull));
+        state.SetComplexityN(state.range(0));
+    }
+
+    constexpr auto prime = 998244353u;
+    constexpr auto mersenne = (1ull << 61) - 1;
+}
+
+BENCHMARK_TEMPLATE(BM_powers_next, prime)->Range(1<<10, 1<<16);
+BENCHMARK_TEMPLATE(BM_powers_next_n, prime)->Range(1<<10, 1<<16);
+BENCHMARK_TEMPLATE(BM_powers_next, mersenne)->Range(1<<10, 1<<16);
+BENCHMARK_TEMPLATE(BM_powers_next_n, mersenne)->Range(1<<10, 1<<16);
+BENCHMARK_TEMPLATE(BM_recurrence_next, prime)->RangeMultiplier(4)->Range(2, 128);
+BENCHMARK_TEMPLATE(BM_recurrence_next_n, prime)->RangeMultiplier(4)->Range(2, 128);
+BENCHMARK_TEMPLATE(BM_recurrence_next, mersenne)->RangeMultiplier(4)->Range(2, 128);
+BENCHMARK_TEMPLATE(BM_recurrence_next_n, mersenne)->RangeMultiplier(4)->Range(2, 128);
+BENCHMARK_TEMPLATE(BM_recurrence_nth, prime)->RangeMultiplier(4)->Range(2, 1<<12)->Complexity();
+BENCHMARK_TEMPLATE(BM_recurrence_nth, mersenne)->RangeMultiplier(4)->Range(2, 1<<12)->Complexity();
@@ -0,0 +1,99 @@
+#include <benchmark/benchmark.h>
+#include "z_module.hpp"
+#include "z_module_sparse.hpp"
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace{
+    constexpr std::size_t rows = 1000000;
+
+    template <auto N>
+    std::vector<fgs::Z<N>> random_elements(std::size_t n, std::uint64_t seed){
+        std::vector<fgs::Z<N>> v(n);
+        for (auto &e : v){
+            seed = seed*6364136223846793005ull + 1442695040888963407ull;
+            e = fgs::Z<N>{seed >> 11};
+        }
+        return v;
+    }
+
+    // Synthetic 10^6 x 10^6 matrices with random columns. Regular ones have 8
+    // entries per row, and skewed ones from 1 to 15 (8 on average too)
+    template <auto N, bool Regular, fgs::sparse_layout Layout>
+    const fgs::sparse_zmatrix<N>& synthetic_matrix(){
+        static const fgs::sparse_zmatrix<N> m = [](){
+            std::vector<typename fgs::sparse_zmatrix<N>::entry> entries;
+            entries.reserve(8*rows);
+            std::uint64_t x = 0x9E3779B97F4A7C15ull;
+            for (std::size_t r=0; r<rows; ++r){
+                const std::size_t length = Regular ? 8 : 1 + (r*2654435761u) % 15;
+                for (std::size_t i=0; i<length; ++i){
+                    x = x*6364136223846793005ull + 1442695040888963407ull;
+                    entries.push_back({r, (x >> 20) % rows, fgs::Z<N>{x >> 7}});
+                }
+            }
+            return fgs::sparse_zmatrix<N>(rows, rows, entries, Layout);
+        }();
+        return m;
+    }
+
+    template <auto N, bool Regular, fgs::sparse_layout Layout>
+    void BM_spmv(benchmark::State &state){
+        const auto &a = synthetic_matrix<N, Regular, Layout>();
+        const auto x = random_elements<N>(rows, 1);
+        std::vector<fgs::Z<N>> y(rows);
+
+        for (auto _ : state){
+            a.multiply(x, y);
+            benchmark::DoNotOptimize(y.data());
+        }
+        state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(a.nonzeros()));
+    }
+
+    // K products with a single pass over the matrix. Items are entries times vectors
+    template <auto N, std::size_t K>
+    void BM_spmv_block(benchmark::State &state){
+        const auto &a = synthetic_matrix<N, true, fgs::sparse_layout::csr>();
+        const auto values = random_elements<N>(rows*K, 1);
+        std::vector<std::array<fgs::Z<N>, K>> x(rows), y(rows);
+        for (std::size_t i=0; i<rows; ++i)
+            for (std::size_t k=0; k<K; ++k)
+                x[i][k] = values[i*K + k];
+
+        for (auto _ : state){
+            a.template multiply<K>(x, y);
+            benchmark::DoNotOptimize(y.data());
+        }
+        state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(a.nonzeros() * K));
+    }
+
+    // Minimal polynomial of a sequence of order n/2
+    template <auto N>
+    void BM_berlekamp_massey(benchmark::State &state){
+        const auto n = static_cast<std::size_t>(state.range(0));
+        fgs::linear_recurrence rec(random_elements<N>(n/2, 1), random_elements<N>(n/2, 2));
+        std::vector<fgs::Z<N>> s(n);
+        rec.next_n(s);
+
+        for (auto _ : state)
+            benchmark::DoNotOptimize(fgs::berlekamp_massey<N>(s));
+        state.SetComplexityN(state.range(0));
+    }
+
+    constexpr auto prime = 998244353u;
+    constexpr auto mersenne = (1ull << 61) - 1;
+
+    using fgs::sparse_layout;
+}
+
+BENCHMARK_TEMPLATE(BM_spmv, prime, true, sparse_layout::csr)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_spmv, prime, true, sparse_layout::ell)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_spmv, prime, false, sparse_layout::csr)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_spmv, prime, false, sparse_layout::ell)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_spmv, mersenne, true, sparse_layout::csr)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_spmv_block, prime, 4)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_spmv_block, prime, 8)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_spmv_block, mersenne, 4)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_berlekamp_massey, prime)->RangeMultiplier(4)->Range(1<<8, 1<<12)->Complexity();
@@ -0,0 +1,262 @@
+#ifndef Z_MODULE_ARITHMETIC_HPP__
+#define Z_MODULE_ARITHMETIC_HPP__
+
+#include "concepts.hpp"
+
+#include <bit>          // std::bit_width, std::has_single_bit
+#include <cstddef>      // std::size_t
+#include <cstdint>
+#include <limits>       // std::numeric_limits
+#include <type_traits>
+
+namespace fgs::detail{
+    // GCC and Clang provide 128 bits integers as an extension, so we need
+    // to mark it that way to keep -Wpedantic quiet
+    __extension__ using uint128_t = unsigned __int128;
+    __extension__ using int128_t  = __int128;
+
+    // Unsigned type able to hold the product of two values of type T
+    template <std::unsigned_integral T>
+    using wide_t = std::conditional_t<(sizeof(T) < sizeof(std::uint32_t)), std::uint32_t,
+                   std::conditional_t<(sizeof(T) < sizeof(std::uint64_t)), std::uint64_t,
+                                      uint128_t>>;
+
+    // In strict ISO mode the 128 bits integers are not integral types, so
+    // they need to be accepted explicitly
+    template <typename T>
+    concept unsigned_word = std::unsigned_integral<T> || std::same_as<T, uint128_t>;
+
+    // Unsigned type for the magnitude of an integral T. bool has no
+    // make_unsigned_t, so it's taken as an unsigned char
+    template <std::integral T>
+    using magnitude_t = std::make_unsigned_t<std::conditional_t<std::same_as<T, bool>, unsigned char, T>>;
+
+    template <typename T>
+    inline constexpr int digits_v = std::numeric_limits<T>::digits;
+    template <>
+    inline constexpr int digits_v<uint128_t> = 128;
+
+    /* Compile-time classification of a modulus N, with 2^(k-1) <= N < 2^k:
+     *
+     *      -Power of two (N = 2^(k-1)): reduction is a mask
+     *      -Pseudo-Mersenne (N = 2^k - c, with c < 2^(k/2)): since 2^k = c (mod N),
+     *       the bits above k can be folded with a multiplication by c and an
+     *       addition. 2^61-1, 2^31-1 or 2^64-59 fall in this category
+     *      -Anything else: plain %
+     */
+    template <auto N>
+    struct modulus_traits{
+        using value_type = decltype(N);
+
+        static constexpr int k = std::bit_width(N);
+        static constexpr bool is_power_of_two = std::has_single_bit(N);
+        static constexpr value_type mask = N - 1;   // Only meaningful for powers of two
+
+        // 2^k - N, computed in a type where 2^k doesn't overflow
+        static constexpr value_type c = static_cast<value_type>(
+            (wide_t<value_type>(1) << k) - N
+        );
+        static constexpr bool is_pseudo_mersenne =
+            !is_power_of_two && k > 2 && c < (wide_t<value_type>(1) << (k/2));
+    };
+
+    // Reduces any unsigned value modulo N
+    template <auto N, unsigned_word W>
+    constexpr decltype(N) reduce(W x) noexcept {
+        using traits = modulus_traits<N>;
+        using value_type = typename traits::value_type;
+        // Work in the wider of both types, so N is representable
+        using U = std::conditional_t<(sizeof(W) > sizeof(value_type)), W, value_type>;
+
+        U y = x;
+        if constexpr (traits::is_power_of_two){
+            return static_cast<value_type>(y & traits::mask);
+        }
+        else if constexpr (traits::is_pseudo_mersenne){
+            if constexpr (traits::k < digits_v<U>){
+                constexpr U low = (U(1) << traits::k) - 1;
+                while (y >> traits::k)
+                    y = (y >> traits::k) * traits::c + (y & low);
+            }
+            // y < 2^k < 2N at this point
+            if (y >= N)
+                y -= N;
+            return static_cast<value_type>(y);
+        }
+        else{
+            return static_cast<value_type>(y % N);
+        }
+    }
+
+    // a + b (mod N), with a, b in [0, N)
+    template <auto N>
+    constexpr decltype(N) add_mod(const decltype(N) &a, const decltype(N) &b) noexcept {
+        using traits = modulus_traits<N>;
+        using value_type = typename traits::value_type;
+
+        if constexpr (traits::is_power_of_two)
+            return static_cast<value_type>((a + b) & traits::mask);
+        else    // This comparison avoids overflows when N is near the limit of value_type
+            return (a >= N - b) ? static_cast<value_type>(a - (N - b))
+                                : static_cast<value_type>(a + b);
+    }
+
+    // a - b (mod N), with a, b in [0, N)
+    template <auto N>
+    constexpr decltype(N) sub_mod(const decltype(N) &a, const decltype(N) &b) noexcept {
+        using traits = modulus_traits<N>;
+        using value_type = typename traits::value_type;
+
+        if constexpr (traits::is_power_of_two)
+            return static_cast<value_type>((a - b) & traits::mask);
+        else
+            return (a >= b) ? static_cast<value_type>(a - b)
+                            : static_cast<value_type>(a + (N - b));
+    }
+
+    // Whether every value of the integral type T is already in [0, N)
+    template <auto N, std::integral T>
+    inline constexpr bool always_reduced =
+        static_cast<uint128_t>(std::numeric_limits<T>::max()) < static_cast<uint128_t>(N);
+
+    // Residue of any integral value modulo N
+    template <auto N, std::integral T>
+    constexpr decltype(N) reduce_integral(const T &x) noexcept {
+        using traits = modulus_traits<N>;
+        using value_type = typename traits::value_type;
+
+        if constexpr (always_reduced<N, T>){
+            if constexpr (std::unsigned_integral<T>)
+                return static_cast<value_type>(x);
+            else{   // |x| <= max+1 <= N, and the equality would need N to be a power of two
+                using U = std::make_unsigned_t<T>;
+                return (x < 0)
+                    ? static_cast<value_type>(N - static_cast<U>(U(0) - static_cast<U>(x)))
+                    : static_cast<value_type>(x);
+            }
+        }
+        else if constexpr (std::unsigned_integral<T>){
+            return reduce<N>(x);
+        }
+        else{
+            using U = std::make_unsigned_t<T>;
+            if constexpr (traits::is_power_of_two){
+                // The conversion to unsigned is a reduction modulo 2^bits, and N divides it
+                using W = std::conditional_t<(sizeof(U) > sizeof(value_type)), U, value_type>;
+                return reduce<N>(static_cast<W>(x));
+            }
+            else{   // The magnitude is taken in the unsigned type, so the minimum value doesn't overflow
+                return (x < 0)
+                    ? sub_mod<N>(0, reduce<N>(static_cast<U>(U(0) - static_cast<U>(x))))
+                    : reduce<N>(static_cast<U>(x));
+            }
+        }
+    }
+
+    // Whether x lies in [0, N), so it can be taken as a residue with no reduction
+    template <auto N, std::integral T>
+    constexpr bool is_reduced(const T &x) noexcept {
+        if constexpr (always_reduced<N, T>){
+            if constexpr (std::unsigned_integral<T>)
+                return true;
+            else
+                return x >= 0;
+        }
+        else{   // N is representable in T here
+            if constexpr (std::unsigned_integral<T>)
+                return x < static_cast<T>(N);
+            else
+                return x >= 0 && x < static_cast<T>(N);
+        }
+    }
+
+    // a * b (mod N), computing the product in a wider type so it doesn't overflow
+    template <auto N>
+    constexpr decltype(N) mul_mod(const decltype(N) &a, const decltype(N) &b) noexcept {
+        using value_type = decltype(N);
+        return reduce<N>(static_cast<wide_t<value_type>>(a) * b);
+    }
+
+    /* Lazy sums of products of residues: the products are added up in a
+     * wide accumulator, which is only reduced when the next `terms` of them
+     * could overflow it, instead of after every addition. Moduli up to 32
+     * bits use a 64 bits accumulator (4 products between reductions for a
+     * 31 bits N, billions for a 16 bits one), and bigger ones a 128 bits one
+     */
+    template <auto N>
+    struct lazy_accumulator{
+        using value_type = decltype(N);
+        using type = std::conditional_t<(N <= std::numeric_limits<std::uint32_t>::max()),
+                                        std::uint64_t, uint128_t>;
+
+        // Products that can be added to a reduced accumulator, at least one
+        // since (N-1) + (N-1)^2 < N^2
+        static constexpr std::size_t terms = [](){
+            constexpr type max_product = static_cast<type>(N-1) * static_cast<type>(N-1);
+            constexpr type count = static_cast<type>(~type(0) - (N-1)) / max_product;
+            return (count > std::numeric_limits<std::size_t>::max())
+                ? std::numeric_limits<std::size_t>::max()
+                : static_cast<std::size_t>(count);
+        }();
+    };
+
+    // Sum of product(j) over j in [0, n), with each product(j) the product of
+    // two residues in lazy_accumulator<N>::type
+    template <auto N, typename F>
+    constexpr decltype(N) lazy_sum(std::size_t n, F &&product) noexcept {
+        using traits = lazy_accumulator<N>;
+
+        typename traits::type acc = 0;
+        for (std::size_t j=0; j<n; ){
+            const std::size_t end = (n - j <= traits::terms) ? n : j + traits::terms;
+            for (; j<end; ++j)
+                acc += product(j);
+            if (j < n)
+                acc = reduce<N>(acc);
+        }
+        return reduce<N>(acc);
+    }
+
+    /* Shoup's multiplication by a fixed operand w. With B the bits of value_type
+     * and w' = floor(w*2^B / N), the high half of x*w' is either floor(x*w/N)
+     * or one less, so x*w - hi(x*w')*N lies in [0, 2N) and a conditional
+     * subtraction finishes the job. That's three products, but only the high
+     * half of x*w' and the low halves of x*w and hi(x*w')*N are needed.
+     * It needs 2N to fit in value_type, and powers of two are already a mask,
+     * so those moduli keep using mul_mod
+     */
+    template <auto N>
+    inline constexpr bool uses_shoup =
+        !modulus_traits<N>::is_power_of_two && N < (decltype(N)(1) << (digits_v<decltype(N)>-1));
+
+    template <auto N>
+    constexpr decltype(N) shoup_quotient(const decltype(N) &w) noexcept {
+        using value_type = decltype(N);
+        return static_cast<value_type>(
+            (static_cast<wide_t<value_type>>(w) << digits_v<value_type>) / N
+        );
+    }
+
+    template <auto N>
+    constexpr decltype(N) mul_shoup(const decltype(N) &x,
+                                    const decltype(N) &w,
+                                    const decltype(N) &w_quotient) noexcept
+    {
+        using value_type = decltype(N);
+        using wide_type = wide_t<value_type>;
+
+        const auto q = static_cast<value_type>(
+            (static_cast<wide_type>(x) * w_quotient) >> digits_v<value_type>
+        );
+        // Only the low halves of the products are needed, the difference is exact
+        auto r = static_cast<value_type>(
+            static_cast<value_type>(static_cast<wide_type>(x) * w) -
+            static_cast<value_type>(static_cast<wide_type>(q) * N)
+        );
+        if (r >= N)
+            r -= N;
+        return r;
+    }
+}  // namespace fgs::detail
+
+#endif
@@ -0,0 +1,116 @@
+#ifndef Z_MODULE_FACTORIZATION_HPP__
+#define Z_MODULE_FACTORIZATION_HPP__
+
+#include "arithmetic.hpp"
+#include "prime_check.hpp"
+
+#include <algorithm>    // std::sort
+#include <array>        // std::array
+#include <cstddef>      // std::size_t
+#include <cstdint>      // std::uint64_t
+#include <numeric>      // std::gcd
+
+namespace fgs::detail{
+    /* Compile-time factorization of moduli up to 64 bits. Small factors are
+     * removed by trial division, and the rest is split with Pollard-Brent rho
+     * and the deterministic Miller-Rabin test of prime_check.hpp, so moduli with big prime factors
+     * stay well below the constexpr evaluation limits
+     */
+    // Some non trivial factor of an odd composite n
+    constexpr std::uint64_t pollard_brent (std::uint64_t n) noexcept {
+        // Differences are accumulated and the gcd is only taken every m steps
+        constexpr std::uint64_t m = 128;
+        const auto distance = [](std::uint64_t a, std::uint64_t b){ return (a > b) ? a-b : b-a; };
+
+        for (std::uint64_t c=1; ; ++c){
+            const auto f = [=](std::uint64_t x){
+                const std::uint64_t y = mul_mod64(x, x, n);
+                return (y >= n - c) ? y - (n - c) : y + c;
+            };
+
+            std::uint64_t x = 0, y = 2, ys = 2, q = 1, g = 1;
+            for (std::uint64_t r=1; g == 1; r *= 2){
+                x = y;
+                for (std::uint64_t i=0; i<r; ++i)
+                    y = f(y);
+
+                for (std::uint64_t k=0; k<r && g == 1; k += m){
+                    ys = y;
+                    for (std::uint64_t i=0; i<m && i<r-k; ++i){
+                        y = f(y);
+                        q = mul_mod64(q, distance(x, y), n);
+                    }
+                    g = std::gcd(q, n);
+                }
+            }
+
+            // The batch overshot, so it's repeated one step at a time
+            if (g == n){
+                do{
+                    ys = f(ys);
+                    g = std::gcd(distance(x, ys), n);
+                } while (g == 1);
+            }
+
+            if (g != n)
+                return g;
+        }
+    }
+
+    // n = powers[0] * ... * powers[count-1], with powers[i] = primes[i]^exponents[i]
+    // and increasing primes. 16 primes are enough, since the product of the
+    // first 16 primes exceeds 2^64
+    struct factorization{
+        static constexpr std::size_t max_factors = 16;
+
+        std::array<std::uint64_t, max_factors> primes{};
+        std::array<int, max_factors> exponents{};
+        std::array<std::uint64_t, max_factors> powers{};
+        std::size_t count = 0;
+    };
+
+    constexpr factorization factorize (std::uint64_t n) noexcept {
+        // Prime factors with multiplicity, and composites pending to be split
+        std::array<std::uint64_t, 64> found{}, pending{};
+        std::size_t n_found = 0, n_pending = 0;
+
+        for (std::uint64_t p=2; p<64 && p*p <= n; ++p){
+            while (n % p == 0){
+                found[n_found++] = p;
+                n /= p;
+            }
+        }
+        if (n > 1)
+            pending[n_pending++] = n;
+
+        while (n_pending > 0){
+            const std::uint64_t x = pending[--n_pending];
+            if (is_prime64(x)){
+                found[n_found++] = x;
+            }
+            else{
+                const std::uint64_t d = pollard_brent(x);
+                pending[n_pending++] = d;
+                pending[n_pending++] = x / d;
+            }
+        }
+
+        std::sort(found.begin(), found.begin() + static_cast<std::ptrdiff_t>(n_found));
+
+        factorization ret;
+        for (std::size_t i=0; i<n_found; ++i){
+            if (ret.count > 0 && ret.primes[ret.count-1] == found[i]){
+                ++ret.exponents[ret.count-1];
+                ret.powers[ret.count-1] *= found[i];
+            }
+            else{
+                ret.primes[ret.count] = ret.powers[ret.count] = found[i];
+                ret.exponents[ret.count] = 1;
+                ++ret.count;
+            }
+        }
+        return ret;
+    }
+}  // namespace fgs::detail
+
+#endif
@@ -1,9 +1,12 @@
 #ifndef Z_MODULE_IO_HELPER_HPP__
 #define Z_MODULE_IO_HELPER_HPP__
 
+#include "arithmetic.hpp"
 #include "concepts.hpp"
+#include "stats_counters.hpp"
 
 #include <string>
+#include <string_view>
 
 #ifdef FGS_EXCEPTIONS_SUPPORT
     #include <exception>
@@ -52,12 +55,14 @@ namespace fgs::detail{
     }
 
     // Function to calculate the module of an integer represented as a string
-    template <typename CharT, typename Traits>
-    constexpr auto mod_aux(const std::basic_string_view<CharT, Traits> &s, std::integral auto N)
+    template <auto N, typename CharT, typename Traits>
+    constexpr auto mod_aux(const std::basic_string_view<CharT, Traits> &s)
 #   ifndef FGS_EXCEPTIONS_SUPPORT
         noexcept
 #   endif
     {
+        const stats::scoped_timer<N> timer{stats::operation::parse};
+
         // If exceptions are enabled, we parse the string and throw if it
         // cannot be converted to an integer
         //
@@ -66,13 +71,15 @@ namespace fgs::detail{
         if (!std::regex_match(begin(s), end(s), std::regex{"^[+-]?[0-9]+$"}))
             throw std::invalid_argument("The string cannot be converted to an integer");
 #endif
-        decltype(N) res = 0;
+        using value_type = decltype(N);
+        value_type res = 0;
 
+        // The accumulation is done in a wider type, so big moduli don't overflow
         for (std::size_t i=(s[0]=='+' || s[0]=='-')?1:0; i<s.size(); ++i)
-            res = (res*10 + static_cast<decltype(N)>(s[i] - '0')) % N;
+            res = reduce<N>(static_cast<wide_t<value_type>>(res)*10 + static_cast<value_type>(s[i] - '0'));
 
         // Little adjustment at return point in case it was negative
-        return (s[0] == '-') ? N - res : res;
+        return (s[0] == '-') ? sub_mod<N>(0, res) : res;
     }
 }  // namespace fgs::detail
 
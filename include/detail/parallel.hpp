@@ -0,0 +1,63 @@
+#ifndef Z_MODULE_PARALLEL_HPP__
+#define Z_MODULE_PARALLEL_HPP__
+
+#include <algorithm>    // std::clamp, std::min
+#include <cstddef>      // std::size_t
+#include <thread>       // std::jthread, std::thread::hardware_concurrency
+#include <type_traits>  // std::integral_constant
+#include <utility>      // std::index_sequence, std::make_index_sequence
+#include <vector>       // std::vector
+
+namespace fgs::detail{
+    // Below this many elements per thread, spawning the threads costs more
+    // than what they save
+    inline constexpr std::size_t parallel_grain = std::size_t(1) << 15;
+
+    // Number of threads worth using for n elements
+    inline std::size_t parallel_threads (std::size_t n) noexcept {
+        const std::size_t hardware = std::max(1u, std::thread::hardware_concurrency());
+        return std::clamp(n / parallel_grain, std::size_t(1), hardware);
+    }
+
+    // Calls f(begin, end) over contiguous chunks of [0, n), one per thread.
+    // The calling thread takes the first chunk, and everything is finished
+    // when this returns
+    template <typename F>
+    void parallel_for (std::size_t n, F &&f){
+        const std::size_t threads = parallel_threads(n);
+        if (threads == 1){
+            f(std::size_t(0), n);
+            return;
+        }
+
+        const std::size_t chunk = (n + threads - 1) / threads;
+        std::vector<std::jthread> workers;
+        workers.reserve(threads-1);
+        for (std::size_t t=1; t<threads; ++t){
+            const std::size_t lo = t*chunk, hi = std::min(n, lo + chunk);
+            if (lo < hi)
+                workers.emplace_back([&f, lo, hi]{ f(lo, hi); });
+        }
+        f(std::size_t(0), std::min(n, chunk));
+    }
+
+    // Calls f(std::integral_constant<std::size_t, I>{}) for every I in [0, K),
+    // each call in its own thread when parallel is true
+    template <std::size_t K, typename F>
+    void parallel_invoke (bool parallel, F &&f){
+        [&]<std::size_t... I>(std::index_sequence<I...>){
+            if (!parallel || K == 1){
+                (f(std::integral_constant<std::size_t, I>{}), ...);
+            }
+            else{
+                std::vector<std::jthread> workers;
+                workers.reserve(K-1);
+                ((I == 0 ? void()
+                         : void(workers.emplace_back([&f]{ f(std::integral_constant<std::size_t, I>{}); }))), ...);
+                f(std::integral_constant<std::size_t, 0>{});
+            }
+        }(std::make_index_sequence<K>{});
+    }
+}  // namespace fgs::detail
+
+#endif
@@ -1,98 +1,87 @@
 #ifndef Z_MODULE_PRIME_CHECK_HPP__
 #define Z_MODULE_PRIME_CHECK_HPP__
 
+#include "arithmetic.hpp"
 #include "concepts.hpp"
 
-#include <array>
-#include <limits>
+#include <array>      // std::array
+#include <cstdint>    // std::uint64_t
+#include <utility>    // std::exchange
 
 namespace fgs::detail{
 
-    // Compile-time primality test "highly optimized" to accept large inputs
-#ifdef __cpp_consteval
-    consteval
-#else
-    constexpr
-#endif
-    bool is_prime(std::integral auto N){
-        if (N < 2)
-            return false;
+    // Arithmetic modulo any m < 2^64, through 128 bits products
+    constexpr std::uint64_t mul_mod64 (std::uint64_t a, std::uint64_t b, std::uint64_t m) noexcept {
+        return static_cast<std::uint64_t>(static_cast<uint128_t>(a) * b % m);
+    }
 
-        using value_type = decltype(N);
+    constexpr std::uint64_t pow_mod64 (std::uint64_t a, std::uint64_t e, std::uint64_t m) noexcept {
+        std::uint64_t ret = 1 % m;
+        for (a %= m; e > 0; e >>= 1){
+            if (e & 1)
+                ret = mul_mod64(ret, a, m);
+            a = mul_mod64(a, a, m);
+        }
+        return ret;
+    }
 
-        // Base cases to create the sieve
-        constexpr std::array base_primes = { // <-- Deduction guides in action
-            value_type(2),
-            value_type(3),
-            value_type(5),
-            value_type(7),
-        };
-        value_type next_prime = 11;
-        value_type increment = 1;
+    // a^-1 (mod m), for coprime a and m. The Bezout coefficients are kept
+    // reduced modulo m, so any m works, and nothing is checked
+    constexpr std::uint64_t inverse_mod64 (std::uint64_t a, std::uint64_t m) noexcept {
+        std::uint64_t b = m, x0 = 1 % m, x1 = 0;
+        for (a %= m; b != 0; ){
+            const std::uint64_t q = a / b;
+            a = std::exchange(b, a - q*b);
+            const std::uint64_t qx = mul_mod64(q % m, x1, m);
+            x0 = std::exchange(x1, (x0 >= qx) ? x0 - qx : x0 + (m - qx));
+        }
+        return x0;
+    }
 
-        // We just test against the base primes
-        for (auto const &i : base_primes){
-            if (N == i)   return true;
-            if (N%i == 0) return false;
+    inline constexpr std::array<std::uint64_t, 12> miller_rabin_bases{
+        2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37
+    };
 
-            // step size for the main loop
-            increment *= i;
-        }
+    // These bases are enough for every n < 2^64
+    constexpr bool is_prime64 (std::uint64_t n) noexcept {
+        if (n < 2)
+            return false;
+        for (const auto p : miller_rabin_bases)
+            if (n % p == 0)
+                return n == p;
 
-        // Main loop. Since I can't generate the cases, they're handwritten
-        for (value_type i=next_prime; i*i < N; i += increment){
-            if (N%(i+0)  == 0) return false;
-            if (N%(i+2)  == 0) return false;
-            if (N%(i+6)  == 0) return false;
-            if (N%(i+8)  == 0) return false;
-            if (N%(i+12) == 0) return false;
-            if (N%(i+18) == 0) return false;
-            if (N%(i+20) == 0) return false;
-            if (N%(i+26) == 0) return false;
-            if (N%(i+30) == 0) return false;
-            if (N%(i+32) == 0) return false;
-            if (N%(i+36) == 0) return false;
-            if (N%(i+42) == 0) return false;
-            if (N%(i+48) == 0) return false;
-            if (N%(i+50) == 0) return false;
-            if (N%(i+56) == 0) return false;
-            if (N%(i+60) == 0) return false;
-            if (N%(i+62) == 0) return false;
-            if (N%(i+68) == 0) return false;
-            if (N%(i+72) == 0) return false;
-            if (N%(i+78) == 0) return false;
-            if (N%(i+86) == 0) return false;
-            if (N%(i+90) == 0) return false;
-            if (N%(i+92) == 0) return false;
-            if (N%(i+96) == 0) return false;
-            if (N%(i+98) == 0) return false;
-            if (N%(i+102) == 0) return false;
-            if (N%(i+110) == 0) return false;
-            if (N%(i+116) == 0) return false;
-            if (N%(i+120) == 0) return false;
-            if (N%(i+126) == 0) return false;
-            if (N%(i+128) == 0) return false;
-            if (N%(i+132) == 0) return false;
-            if (N%(i+138) == 0) return false;
-            if (N%(i+140) == 0) return false;
-            if (N%(i+146) == 0) return false;
-            if (N%(i+152) == 0) return false;
-            if (N%(i+156) == 0) return false;
-            if (N%(i+158) == 0) return false;
-            if (N%(i+162) == 0) return false;
-            if (N%(i+168) == 0) return false;
-            if (N%(i+170) == 0) return false;
-            if (N%(i+176) == 0) return false;
-            if (N%(i+180) == 0) return false;
-            if (N%(i+182) == 0) return false;
-            if (N%(i+186) == 0) return false;
-            if (N%(i+188) == 0) return false;
-            if (N%(i+198) == 0) return false;
-            if (N%(i+200) == 0) return false;
-        }
+        std::uint64_t d = n-1;
+        int s = 0;
+        for (; d%2 == 0; d /= 2)
+            ++s;
+
+        for (const auto a : miller_rabin_bases){
+            std::uint64_t x = pow_mod64(a, d, n);
+            if (x == 1 || x == n-1)
+                continue;
 
+            bool composite = true;
+            for (int i=1; i<s && composite; ++i){
+                x = mul_mod64(x, x, n);
+                composite = (x != n-1);
+            }
+            if (composite)
+                return false;
+        }
         return true;
     }
+
+    // Compile-time primality test. Miller-Rabin needs a few hundred modular
+    // products even for 64 bits moduli, which trial division can't do
+    // within the constexpr evaluation limits
+#ifdef __cpp_consteval
+    consteval
+#else
+    constexpr
+#endif
+    bool is_prime(std::integral auto N){
+        return N >= 2 && is_prime64(static_cast<std::uint64_t>(N));
+    }
 }  // namespace fgs::detail
 
 #endif
@@ -0,0 +1,191 @@
+#ifndef Z_MODULE_STATS_COUNTERS_HPP__
+#define Z_MODULE_STATS_COUNTERS_HPP__
+
+#include <array>        // std::array
+#include <cstddef>      // std::size_t
+#include <cstdint>      // std::uint64_t
+#include <type_traits>  // std::is_constant_evaluated
+
+#ifdef FGS_STATS_SUPPORT
+    #include <atomic>   // std::atomic
+    #include <chrono>   // std::chrono::steady_clock
+    #include <map>      // std::map
+    #include <mutex>    // std::mutex, std::lock_guard
+    #include <vector>   // std::vector
+#endif
+
+/* Operation counters for z-modules, enabled with FGS_STATS_SUPPORT.
+ *
+ * Every thread owns one block of counters per modulus it uses, so the hot
+ * paths only touch memory of their own thread (each block is aligned to a
+ * cache line to avoid false sharing). Blocks are registered in a global
+ * registry, which aggregates them on demand and keeps the totals of the
+ * threads that already finished.
+ *
+ * Without the macro, every hook is an empty constexpr function.
+ */
+namespace fgs::detail::stats{
+    enum class operation : std::size_t{
+        add, sub, mul, div, inverse, pow, parse, reduce
+    };
+
+    inline constexpr std::size_t operation_count = 8;
+    inline constexpr std::array<const char*, operation_count> operation_names{
+        "add", "sub", "mul", "div", "inverse", "pow", "parse", "reduce"
+    };
+
+    // Aggregated values of a modulus
+    struct totals{
+        std::array<std::uint64_t, operation_count> counts{};
+        std::array<std::uint64_t, operation_count> nanoseconds{};
+    };
+
+#ifdef FGS_STATS_SUPPORT
+    // 64 bytes is the cache line size of every common target
+    // (std::hardware_destructive_interference_size is not ABI stable)
+    struct alignas(64) counters{
+        std::uint64_t modulus = 0;
+        // Only the owner thread writes, so relaxed load+store is enough and
+        // doesn't need locked instructions. Atomics make concurrent
+        // snapshots well defined
+        std::array<std::atomic<std::uint64_t>, operation_count> counts{};
+        std::array<std::atomic<std::uint64_t>, operation_count> nanoseconds{};
+        // Values at the last reset, which the registry subtracts. They are
+        // only used with the registry lock held, so a reset never writes
+        // into the counters of other threads
+        totals baseline{};
+
+        void add (operation op, std::uint64_t ns = 0) noexcept {
+            auto &c = counts[static_cast<std::size_t>(op)];
+            c.store(c.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            if (ns != 0){
+                auto &t = nanoseconds[static_cast<std::size_t>(op)];
+                t.store(t.load(std::memory_order_relaxed) + ns, std::memory_order_relaxed);
+            }
+        }
+    };
+
+    class registry{
+    public:
+        static registry& instance (){
+            static registry r;
+            return r;
+        }
+
+        void attach (counters *c){
+            const std::lock_guard lock{m};
+            live.push_back(c);
+        }
+
+        // The values of finished threads are kept in the totals
+        void detach (counters *c){
+            const std::lock_guard lock{m};
+            accumulate(retired[c->modulus], *c);
+            std::erase(live, c);
+        }
+
+        [[nodiscard]] std::map<std::uint64_t, totals> aggregate (){
+            const std::lock_guard lock{m};
+            std::map<std::uint64_t, totals> ret = retired;
+            for (const counters *c : live)
+                accumulate(ret[c->modulus], *c);
+            return ret;
+        }
+
+        // Live counters keep counting from their current values, which
+        // become the new baselines
+        void reset (){
+            const std::lock_guard lock{m};
+            retired.clear();
+            for (counters *c : live){
+                for (std::size_t i=0; i<operation_count; ++i){
+                    c->baseline.counts[i] = c->counts[i].load(std::memory_order_relaxed);
+                    c->baseline.nanoseconds[i] = c->nanoseconds[i].load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+    private:
+        std::mutex m;
+        std::vector<counters*> live;
+        std::map<std::uint64_t, totals> retired;
+
+        // t += values of c since its last reset. Counters only grow, so
+        // they are never below their baselines
+        static void accumulate (totals &t, const counters &c) noexcept {
+            for (std::size_t i=0; i<operation_count; ++i){
+                t.counts[i] += c.counts[i].load(std::memory_order_relaxed) - c.baseline.counts[i];
+                t.nanoseconds[i] += c.nanoseconds[i].load(std::memory_order_relaxed) - c.baseline.nanoseconds[i];
+            }
+        }
+    };
+
+    // Counters of the calling thread for a modulus, registered on first use
+    struct thread_slot{
+        counters c;
+
+        explicit thread_slot (std::uint64_t modulus){
+            c.modulus = modulus;
+            registry::instance().attach(&c);
+        }
+        ~thread_slot (){
+            registry::instance().detach(&c);
+        }
+        thread_slot (const thread_slot&) = delete;
+        thread_slot& operator= (const thread_slot&) = delete;
+    };
+
+    template <auto N>
+    counters& local_counters (){
+        thread_local thread_slot slot{static_cast<std::uint64_t>(N)};
+        return slot.c;
+    }
+#endif
+
+    // Counts one operation in the ring Z<N>
+    template <auto N>
+    constexpr void count ([[maybe_unused]] operation op) noexcept {
+#ifdef FGS_STATS_SUPPORT
+        if (!std::is_constant_evaluated())
+            local_counters<N>().add(op);
+#endif
+    }
+
+    // Counts and times one operation in the ring Z<N> for its whole scope
+    template <auto N>
+    class scoped_timer{
+    public:
+        explicit constexpr scoped_timer ([[maybe_unused]] operation which) noexcept
+#ifdef FGS_STATS_SUPPORT
+            : op{which}
+        {
+            if (!std::is_constant_evaluated())
+                start = std::chrono::steady_clock::now();
+        }
+#else
+        {}
+#endif
+
+        constexpr ~scoped_timer (){
+#ifdef FGS_STATS_SUPPORT
+            if (!std::is_constant_evaluated()){
+                const auto elapsed = std::chrono::steady_clock::now() - start;
+                local_counters<N>().add(op, static_cast<std::uint64_t>(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()
+                ));
+            }
+#endif
+        }
+
+        scoped_timer (const scoped_timer&) = delete;
+        scoped_timer& operator= (const scoped_timer&) = delete;
+
+#ifdef FGS_STATS_SUPPORT
+    private:
+        operation op;
+        std::chrono::steady_clock::time_point start{};
+#endif
+    };
+}  // namespace fgs::detail::stats
+
+#endif
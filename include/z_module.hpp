@@ -2,10 +2,14 @@
 #define Z_MODULE_HPP__
 
 #include "detail/concepts.hpp"
+#include "detail/arithmetic.hpp"
 #include "detail/common_type.hpp"
 #include "detail/io_helper.hpp"
 #include "detail/prime_check.hpp"
+#include "detail/stats_counters.hpp"
 
+#include <cassert>      // assert
+#include <functional>   // std::hash
 #include <iostream>     // std::basic_istream, std::basic_ostream
 #include <numeric>      // std::gcd
 #include <string>       // std::basic_string
@@ -15,18 +19,23 @@
 // The thing is to mark some specific functions as noexcept
 // depending on this macro, so we are going to define a new one
 // with boolean values for that purpose.
-#ifndef FGS_EXCEPTIONS_SUPPORT
-    #include <exception>    // std::domain_error
+#ifdef FGS_EXCEPTIONS_SUPPORT
+    #include <stdexcept>    // std::domain_error, std::out_of_range
 #endif
 
 namespace fgs{
 
+namespace detail{
+    struct zmodule_access;
+}
+
 // ZModule class for integral values (cardinality bigger than 1)
 template <std::integral auto Integer> requires (Integer > 1)
 class ZModule{
 public:
     template <std::integral auto Integer2> requires (Integer2 > 1)
     friend class ZModule;
+    friend struct detail::zmodule_access;
 
     // Typedef for the value_type
     using value_type = std::make_unsigned_t<decltype(Integer)>;
@@ -42,15 +51,18 @@ public:
     constexpr ZModule& operator= (const ZModule&) = default;
     constexpr ZModule& operator= (ZModule&&)      = default;
 
-    // Constructor specialized for unsigned integral types
-    template <std::unsigned_integral T>
-    explicit constexpr ZModule (const T &other) noexcept
-        : n{other % N} {}
-
-    // Constructor specialized for signed integral types
-    template <std::signed_integral T>
+    // Constructor for integral types. Types whose whole range lies in [0, N)
+    // skip the reduction, and powers of two just mask the two's complement.
+    // Like in the mixed operators, only values out of [0, N) count as a
+    // reduction in the statistics, and masks never do
+    template <std::integral T>
     explicit constexpr ZModule (const T &other) noexcept
-        : n{(other < 0) ? N-(-other)%N : other%N} {}
+        : n{detail::reduce_integral<N>(other)}
+    {
+        if constexpr (!detail::modulus_traits<N>::is_power_of_two)
+            if (!detail::is_reduced<N>(other))
+                detail::stats::count<N>(detail::stats::operation::reduce);
+    }
 
     // Constructor specialized for z-modules of lower or equal cardinalities
     template <auto Integer2>
@@ -63,16 +75,18 @@ public:
     template <auto Integer2>
     requires (N < Integer2)
     explicit constexpr ZModule (const ZModule<Integer2> &other) noexcept
-        : n{other.n % N} {}
+        : n{detail::reduce<N>(other.n)} {}
 
     // Constructor using a different type. The type is required to fulfill
-    // three conditions:
+    // four conditions:
     //      -Implement operator< with integral types (full set of
     //      comparison operators is recommended)
     //      -Implement unary operator-
+    //      -Implement operator% with value_type
     //      -Explicitly convertible to value_type
     template <typename U>
-    requires (!std::integral<U> && std::constructible_from<value_type, U>)
+    requires (!std::integral<U> && std::constructible_from<value_type, U>) &&
+             requires (const U &u){ u < 0; -u; u % N; }
     explicit constexpr ZModule (const U &other) noexcept
         : n{    // This weird initilization is needed to allow constexpr
             (other < 0)
@@ -87,7 +101,7 @@ public:
     #ifndef FGS_EXCEPTIONS_SUPPORT
         noexcept
     #endif
-        : n{detail::mod_aux(s, N)}{}
+        : n{detail::mod_aux<N>(s)}{}
 
     template <typename CharT, typename Traits, typename Allocator>
     explicit constexpr ZModule (const std::basic_string<CharT, Traits, Allocator> &s)
@@ -109,10 +123,12 @@ public:
 
     // Increment and decrement operators
     constexpr ZModule& operator++ () noexcept{
-        n = (n+1)%N;
+        detail::stats::count<N>(detail::stats::operation::add);
+        n = detail::add_mod<N>(n, 1);
         return *this;
     }
     constexpr ZModule& operator-- () noexcept{
+        detail::stats::count<N>(detail::stats::operation::sub);
         n = (n==0)?N-1:n-1;
         return *this;
     }
@@ -129,15 +145,18 @@ public:
 
     // Operator overloadings for modular arithmetic
     constexpr ZModule& operator+= (const ZModule &zm) noexcept {
-        n = (n+zm.n)%N;
+        detail::stats::count<N>(detail::stats::operation::add);
+        n = detail::add_mod<N>(n, zm.n);
         return *this;
     }
     constexpr ZModule& operator-= (const ZModule &zm) noexcept {
-        n = (n+(N-zm.n))%N;
+        detail::stats::count<N>(detail::stats::operation::sub);
+        n = detail::sub_mod<N>(n, zm.n);
         return *this;
     }
     constexpr ZModule& operator*= (const ZModule &zm) noexcept {
-        n = (n*zm.n)%N;
+        detail::stats::count<N>(detail::stats::operation::mul);
+        n = detail::mul_mod<N>(n, zm.n);
         return *this;
     }
     constexpr ZModule& operator/= (const ZModule &zm)
@@ -145,7 +164,8 @@ public:
     noexcept
 #endif
     {
-        n = (n*zm.inverse())%N;
+        detail::stats::count<N>(detail::stats::operation::div);
+        n = detail::mul_mod<N>(n, zm.inverse());
         return *this;
     }
 
@@ -154,17 +174,17 @@ public:
     template<typename U>
     requires std::constructible_from<ZModule<Integer>, U>
     constexpr ZModule& operator+= (const U &other) noexcept {
-        return *this += ZModule{other};
+        return *this += convert(other);
     }
     template<typename U>
     requires std::constructible_from<ZModule<Integer>, U>
     constexpr ZModule& operator-= (const U &other) noexcept {
-        return *this -= ZModule{other};
+        return *this -= convert(other);
     }
     template<typename U>
     requires std::constructible_from<ZModule<Integer>, U>
     constexpr ZModule& operator*= (const U &other) noexcept {
-        return *this *= ZModule{other};
+        return *this *= convert(other);
     }
     template<typename U>
     requires std::constructible_from<ZModule<Integer>, U>
@@ -173,9 +193,54 @@ public:
     noexcept
 #endif
     {
-        return *this /= ZModule{other};
+        return *this /= convert(other);
     }
 
+    // A fixed multiplier with a precomputed Shoup constant: floor(w*2^B / N),
+    // where B is the number of bits of value_type. Multiplying by it needs the
+    // high half of one product, the low halves of two more and a conditional
+    // subtraction instead of a full reduction, which pays off when the same
+    // factor is used many times
+    // (scalar-times-vector loops, NTT twiddle factors...)
+    class precomputed{
+    public:
+        constexpr precomputed () noexcept
+            : precomputed{ZModule(0u)} {}
+
+        explicit constexpr precomputed (const ZModule &zm) noexcept
+            : w{zm.n}, w_quotient{detail::shoup_quotient<N>(zm.n)} {}
+
+        // The multiplier as a plain z-module
+        [[nodiscard]] constexpr ZModule value () const noexcept {
+            ZModule ret{}; ret.n = w;
+            return ret;
+        }
+
+        // zm * w
+        [[nodiscard]] constexpr ZModule multiply (ZModule zm) const noexcept {
+            detail::stats::count<N>(detail::stats::operation::mul);
+            if constexpr (detail::uses_shoup<N>)
+                zm.n = detail::mul_shoup<N>(zm.n, w, w_quotient);
+            else
+                zm.n = detail::mul_mod<N>(zm.n, w);
+            return zm;
+        }
+
+        friend constexpr ZModule& operator*= (ZModule &lhs, const precomputed &rhs) noexcept {
+            return lhs = rhs.multiply(lhs);
+        }
+        friend constexpr ZModule operator* (const ZModule &lhs, const precomputed &rhs) noexcept {
+            return rhs.multiply(lhs);
+        }
+        friend constexpr ZModule operator* (const precomputed &lhs, const ZModule &rhs) noexcept {
+            return lhs.multiply(rhs);
+        }
+
+    private:
+        value_type w;
+        value_type w_quotient;
+    };
+
     // Explicit conversion to any type explicitly convertible to
     // the underlined value_type
     template<std::constructible_from<value_type> T>
@@ -198,8 +263,8 @@ public:
     friend std::basic_istream<CharT, Traits>&
     operator>> (std::basic_istream<CharT, Traits> &is, ZModule &zm){
         // We first need to take the input in a string to parse it
-        std::string input; is >> input;
-        zm.n = detail::mod_aux(input.begin(), input.end(), N);
+        std::basic_string<CharT, Traits> input; is >> input;
+        zm.n = detail::mod_aux<N>(std::basic_string_view<CharT, Traits>{input});
 
         return is;
     }
@@ -214,15 +279,42 @@ public:
 private:
     value_type n;
 
+    // Conversion used by the mixed operators. Types whose whole range lies
+    // in [0, N) never reduce, powers of two just mask (cheaper than checking
+    // the range first), and other integral operands already in [0, N)
+    // (small constants, indices...) are taken as they are, instead of paying
+    // a full reduction
+    template <typename U>
+    static constexpr ZModule convert (const U &other)
+        noexcept(std::is_nothrow_constructible_v<ZModule, U>)
+    {
+        if constexpr (std::integral<U>){
+            ZModule ret{};
+            if constexpr (detail::always_reduced<N, U> || detail::modulus_traits<N>::is_power_of_two)
+                ret.n = detail::reduce_integral<N>(other);
+            else if (detail::is_reduced<N>(other))
+                ret.n = static_cast<value_type>(other);
+            else{
+                detail::stats::count<N>(detail::stats::operation::reduce);
+                ret.n = detail::reduce_integral<N>(other);
+            }
+            return ret;
+        }
+        else
+            return ZModule{other};
+    }
+
     // Calculate the inverse of the number in the ring
     constexpr auto inverse() const
 #ifndef FGS_EXCEPTIONS_SUPPORT
     noexcept
 #endif
     {
+        const detail::stats::scoped_timer<N> timer{detail::stats::operation::inverse};
+
         // If this macro is not defined, impossible operations
         // will be left as undefined behaviour instead of throwing
-#ifndef FGS_EXCEPTIONS_SUPPORT
+#ifdef FGS_EXCEPTIONS_SUPPORT
         if (n == 0)
             throw std::domain_error("Divide by zero exception");
 
@@ -238,18 +330,81 @@ private:
                 throw std::domain_error(std::to_string(n) + " has no inverse in " + NAME);
 #endif
 
-        // TODO: Implement Extended Euclidean Algorithm, this one is slow
-        value_type ret=1;
-        while ((n*ret)%N != 1)
-            ++ret;
-        return ret;
+        // Extended Euclidean Algorithm. The Bezout coefficients are kept
+        // reduced modulo N, so everything fits in value_type
+        //      a = x0*n (mod N),  b = x1*n (mod N)
+        value_type a = n, b = N;
+        value_type x0 = 1, x1 = 0;
+        while (b != 0){
+            // q <= N, with q == N only for n == 1 (second step, a = N and b = 1).
+            // Even then q*x1 < N^2, which mul_mod reduces in the wide type
+            const value_type q = a / b;
+            const value_type r = a - q*b;
+            a = b; b = r;
+
+            const value_type x = detail::sub_mod<N>(x0, detail::mul_mod<N>(q, x1));
+            x0 = x1; x1 = x;
+        }
+        return x0;
     }
 };
 
+namespace detail{
+    // Gives the library kernels direct access to the residue of a z-module,
+    // so values already known to be in [0, N) skip the reduction
+    struct zmodule_access{
+        template <auto Integer>
+        static constexpr ZModule<Integer>
+        from_reduced (const typename ZModule<Integer>::value_type &n) noexcept {
+            ZModule<Integer> ret{};
+            ret.n = n;
+            return ret;
+        }
+
+        template <auto Integer, typename U>
+        static constexpr ZModule<Integer> convert (const U &other)
+            noexcept(std::is_nothrow_constructible_v<ZModule<Integer>, U>)
+        {
+            return ZModule<Integer>::convert(other);
+        }
+
+        template <auto Integer>
+        static constexpr const auto& residue (const ZModule<Integer> &zm) noexcept {
+            return zm.n;
+        }
+    };
+}   // namespace detail
+
+// Builds a z-module from a value the caller knows to be in [0, N), with no
+// reduction at all. Values out of that range are undefined behaviour
+template<auto Integer, std::integral T>
+[[nodiscard]] constexpr ZModule<Integer> assume_reduced (const T &value) noexcept {
+    return detail::zmodule_access::from_reduced<Integer>(
+        static_cast<typename ZModule<Integer>::value_type>(value)
+    );
+}
+
+// Same as assume_reduced, but checking the precondition: it throws with
+// exceptions support, and asserts otherwise (so it's free with NDEBUG)
+template<auto Integer, std::integral T>
+[[nodiscard]] constexpr ZModule<Integer> assume_reduced_checked (const T &value)
+#ifndef FGS_EXCEPTIONS_SUPPORT
+    noexcept
+#endif
+{
+#ifdef FGS_EXCEPTIONS_SUPPORT
+    if (!detail::is_reduced<ZModule<Integer>::N>(value))
+        throw std::out_of_range(std::to_string(value) + " is not reduced in " + ZModule<Integer>::NAME);
+#else
+    assert(detail::is_reduced<ZModule<Integer>::N>(value));
+#endif
+    return assume_reduced<Integer>(value);
+}
+
 // Unary + and - operators
 template<auto Integer>
 constexpr ZModule<Integer> operator+ (const ZModule<Integer> &rhs) noexcept {
-    return ZModule<Integer>(rhs);
+    return rhs;
 }
 template<auto Integer>
 constexpr ZModule<Integer> operator- (const ZModule<Integer> &rhs) noexcept {
@@ -313,15 +468,15 @@ constexpr ZModule<Integer> operator/ (const ZModule<Integer> &lhs, const U &rhs)
 /*------------------------------------------*/
 template<auto Integer, typename U>
 constexpr ZModule<Integer> operator+ (const U &lhs, const ZModule<Integer> &rhs) noexcept {
-   return ZModule<Integer>(lhs) += rhs;
+   return detail::zmodule_access::convert<Integer>(lhs) += rhs;
 }
 template<auto Integer, typename U>
 constexpr ZModule<Integer> operator- (const U &lhs, const ZModule<Integer> &rhs) noexcept {
-   return ZModule<Integer>(lhs) -= rhs;
+   return detail::zmodule_access::convert<Integer>(lhs) -= rhs;
 }
 template<auto Integer, typename U>
 constexpr ZModule<Integer> operator* (const U &lhs, const ZModule<Integer> &rhs) noexcept {
-   return ZModule<Integer>(lhs) *= rhs;
+   return detail::zmodule_access::convert<Integer>(lhs) *= rhs;
 }
 template<auto Integer, typename U>
 constexpr ZModule<Integer> operator/ (const U &lhs, const ZModule<Integer> &rhs)
@@ -329,7 +484,7 @@ constexpr ZModule<Integer> operator/ (const U &lhs, const ZModule<Integer> &rhs)
     noexcept
 #endif
 {
-   return ZModule<Integer>(lhs) /= rhs;
+   return detail::zmodule_access::convert<Integer>(lhs) /= rhs;
 }
 
 // This class is not meant to be used for bitwise operations, so we
@@ -340,14 +495,27 @@ constexpr ZModule<Integer> operator^ (const ZModule<Integer> &base, const std::i
     noexcept
 #endif
 {
-    if (exponent < 0)
-        return (1/base) ^ (-exponent);
-    else if (exponent == 0)
-        return ZModule<Integer>(1);
-    else if (exponent%2 == 0)
-        return (base*base) ^ (exponent/2);
-    else
-        return (base ^ (exponent-1))*base;
+    const detail::stats::scoped_timer<ZModule<Integer>::N> timer{detail::stats::operation::pow};
+
+    // Square and multiply. Negative exponents are powers of the inverse, and
+    // the magnitude is taken in the unsigned type so the minimum doesn't overflow
+    using exponent_type = detail::magnitude_t<std::remove_cvref_t<decltype(exponent)>>;
+    ZModule<Integer> b = base;
+    auto e = static_cast<exponent_type>(exponent);
+    if constexpr (std::signed_integral<std::remove_cvref_t<decltype(exponent)>>){
+        if (exponent < 0){
+            b = 1/base;
+            e = static_cast<exponent_type>(exponent_type(0) - e);
+        }
+    }
+
+    ZModule<Integer> ret(1u);
+    for (; e != 0; e >>= 1){
+        if (e & 1)
+            ret *= b;
+        b *= b;
+    }
+    return ret;
 }
 
 
@@ -398,52 +566,52 @@ constexpr bool operator>= ( const ZModule<Integer1> &lhs,
 // Operator overloadings for comparisons with other types
 template<auto Integer, typename U>
 constexpr bool operator== (const ZModule<Integer> &lhs, const U &rhs) noexcept {
-   return lhs == ZModule<Integer>(rhs);
+   return lhs == detail::zmodule_access::convert<Integer>(rhs);
 }
 template<auto Integer, typename U>
 constexpr bool operator!= (const ZModule<Integer> &lhs, const U &rhs) noexcept {
-   return lhs != ZModule<Integer>(rhs);
+   return lhs != detail::zmodule_access::convert<Integer>(rhs);
 }
 template<auto Integer, typename U>
 constexpr bool operator<  (const ZModule<Integer> &lhs, const U &rhs) noexcept {
-   return lhs <  ZModule<Integer>(rhs);
+   return lhs <  detail::zmodule_access::convert<Integer>(rhs);
 }
 template<auto Integer, typename U>
 constexpr bool operator<= (const ZModule<Integer> &lhs, const U &rhs) noexcept {
-   return lhs <= ZModule<Integer>(rhs);
+   return lhs <= detail::zmodule_access::convert<Integer>(rhs);
 }
 template<auto Integer, typename U>
 constexpr bool operator>  (const ZModule<Integer> &lhs, const U &rhs) noexcept {
-   return lhs >  ZModule<Integer>(rhs);
+   return lhs >  detail::zmodule_access::convert<Integer>(rhs);
 }
 template<auto Integer, typename U>
 constexpr bool operator>= (const ZModule<Integer> &lhs, const U &rhs) noexcept {
-   return lhs >= ZModule<Integer>(rhs);
+   return lhs >= detail::zmodule_access::convert<Integer>(rhs);
 }
 /*------------------------------------------*/
 template<auto Integer, typename U>
 constexpr bool operator== (const U &lhs, const ZModule<Integer> &rhs) noexcept {
-   return ZModule<Integer>(lhs) == rhs;
+   return detail::zmodule_access::convert<Integer>(lhs) == rhs;
 }
 template<auto Integer, typename U>
 constexpr bool operator!= (const U &lhs, const ZModule<Integer> &rhs) noexcept {
-   return ZModule<Integer>(lhs) != rhs;
+   return detail::zmodule_access::convert<Integer>(lhs) != rhs;
 }
 template<auto Integer, typename U>
 constexpr bool operator<  (const U &lhs, const ZModule<Integer> &rhs) noexcept {
-   return ZModule<Integer>(lhs) <  rhs;
+   return detail::zmodule_access::convert<Integer>(lhs) <  rhs;
 }
 template<auto Integer, typename U>
 constexpr bool operator<= (const U &lhs, const ZModule<Integer> &rhs) noexcept {
-   return ZModule<Integer>(lhs) <= rhs;
+   return detail::zmodule_access::convert<Integer>(lhs) <= rhs;
 }
 template<auto Integer, typename U>
 constexpr bool operator>  (const U &lhs, const ZModule<Integer> &rhs) noexcept {
-   return ZModule<Integer>(lhs) >  rhs;
+   return detail::zmodule_access::convert<Integer>(lhs) >  rhs;
 }
 template<auto Integer, typename U>
 constexpr bool operator>= (const U &lhs, const ZModule<Integer> &rhs) noexcept {
-   return ZModule<Integer>(lhs) >= rhs;
+   return detail::zmodule_access::convert<Integer>(lhs) >= rhs;
 }
 
 // Type trait to check if some type is a Z-module
@@ -457,6 +625,21 @@ inline constexpr bool is_z_module<ZModule<Integer>> = true;
 template<auto Integer>
 using Z = ZModule<Integer>;
 
+// Shorter name for the precomputed multipliers
+template<auto Integer>
+using mul_const = typename ZModule<Integer>::precomputed;
+
 }   // namespace fgs
 
+// Hash support, so z-modules can be used directly as keys of unordered containers
+namespace std{
+    template <auto Integer>
+    struct hash<fgs::ZModule<Integer>>{
+        std::size_t operator() (const fgs::ZModule<Integer> &zm) const noexcept {
+            using value_type = typename fgs::ZModule<Integer>::value_type;
+            return std::hash<value_type>{}(static_cast<value_type>(zm));
+        }
+    };
+}
+
 #endif
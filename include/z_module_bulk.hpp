@@ -0,0 +1,153 @@
+#ifndef Z_MODULE_BULK_HPP__
+#define Z_MODULE_BULK_HPP__
+
+#include "z_module.hpp"
+
+#include <concepts>       // std::integral, std::same_as
+#include <cstddef>        // std::size_t
+#include <ranges>         // std::ranges::contiguous_range, std::ranges::output_range, std::ranges::range_value_t
+#include <span>           // std::span
+
+namespace fgs{
+
+/*****************************************************************************/
+/************** Kernels over contiguous sequences of z-modules ***************/
+/*****************************************************************************/
+
+// Sizes of input and output spans are required to be the same, otherwise the
+// behaviour is undefined. Output may alias the input.
+
+// out[i] = in[i] * w
+template <auto Integer>
+constexpr void scale (std::span<const ZModule<Integer>> in,
+                      const mul_const<Integer> &w,
+                      std::span<ZModule<Integer>> out) noexcept
+{
+    for (std::size_t i=0; i<in.size(); ++i)
+        out[i] = in[i] * w;
+}
+
+// v[i] *= w
+template <auto Integer>
+constexpr void scale (std::span<ZModule<Integer>> v, const mul_const<Integer> &w) noexcept {
+    for (auto &e : v)
+        e *= w;
+}
+
+// y[i] += w * x[i]
+template <auto Integer>
+constexpr void axpy (const mul_const<Integer> &w,
+                     std::span<const ZModule<Integer>> x,
+                     std::span<ZModule<Integer>> y) noexcept
+{
+    for (std::size_t i=0; i<x.size(); ++i)
+        y[i] += x[i] * w;
+}
+
+// Overloads for plain multipliers. The Shoup constant is computed once
+// and shared by the whole sequence
+template <auto Integer>
+constexpr void scale (std::span<const ZModule<Integer>> in,
+                      const ZModule<Integer> &w,
+                      std::span<ZModule<Integer>> out) noexcept
+{
+    scale(in, mul_const<Integer>{w}, out);
+}
+
+template <auto Integer>
+constexpr void scale (std::span<ZModule<Integer>> v, const ZModule<Integer> &w) noexcept {
+    scale(v, mul_const<Integer>{w});
+}
+
+template <auto Integer>
+constexpr void axpy (const ZModule<Integer> &w,
+                     std::span<const ZModule<Integer>> x,
+                     std::span<ZModule<Integer>> y) noexcept
+{
+    axpy(mul_const<Integer>{w}, x, y);
+}
+
+namespace detail{
+    // Contiguous ranges of z-modules, and the ones that can also be written
+    template <typename R>
+    concept zmodule_range = std::ranges::contiguous_range<R> &&
+                            is_z_module<std::ranges::range_value_t<R>>;
+
+    template <typename R>
+    concept mutable_zmodule_range = zmodule_range<R> &&
+                                    std::ranges::output_range<R, std::ranges::range_value_t<R>>;
+
+    // Plain or precomputed multiplier for the z-modules of the range R
+    template <typename W, typename R>
+    concept multiplier_for = std::same_as<W, std::ranges::range_value_t<R>> ||
+                             std::same_as<W, typename std::ranges::range_value_t<R>::precomputed>;
+}   // namespace detail
+
+// Overloads for any contiguous range of z-modules (std::vector, std::array,
+// spans of non-const elements...), which are just viewed as spans
+template <detail::zmodule_range In, typename W, detail::mutable_zmodule_range Out>
+requires std::same_as<std::ranges::range_value_t<In>, std::ranges::range_value_t<Out>> &&
+         detail::multiplier_for<W, In>
+constexpr void scale (const In &in, const W &w, Out &&out) noexcept {
+    using zm_t = std::ranges::range_value_t<In>;
+    scale(std::span<const zm_t>{in}, w, std::span<zm_t>{out});
+}
+
+template <detail::mutable_zmodule_range R, typename W>
+requires detail::multiplier_for<W, R>
+constexpr void scale (R &&v, const W &w) noexcept {
+    scale(std::span<std::ranges::range_value_t<R>>{v}, w);
+}
+
+template <typename W, detail::zmodule_range In, detail::mutable_zmodule_range Out>
+requires std::same_as<std::ranges::range_value_t<In>, std::ranges::range_value_t<Out>> &&
+         detail::multiplier_for<W, In>
+constexpr void axpy (const W &w, const In &x, Out &&y) noexcept {
+    using zm_t = std::ranges::range_value_t<In>;
+    axpy(w, std::span<const zm_t>{x}, std::span<zm_t>{y});
+}
+
+/*****************************************************************************/
+/************* Bulk conversions between integers and z-modules ***************/
+/*****************************************************************************/
+
+// out[i] = ZModule<Integer>(in[i]), with the same reduction as the
+// constructor (masks for powers of two, folds for pseudo-Mersenne moduli,
+// a multiplication by a precomputed reciprocal otherwise)
+template <std::integral T, auto Integer>
+constexpr void reduce_into (std::span<const T> in, std::span<ZModule<Integer>> out) noexcept {
+    for (std::size_t i=0; i<in.size(); ++i)
+        out[i] = detail::zmodule_access::from_reduced<Integer>(
+            detail::reduce_integral<ZModule<Integer>::N>(in[i])
+        );
+}
+
+// out[i] = static_cast<T>(in[i]). T must be able to represent all of [0, N)
+template <auto Integer, std::integral T>
+constexpr void lift_from (std::span<const ZModule<Integer>> in, std::span<T> out) noexcept {
+    for (std::size_t i=0; i<in.size(); ++i)
+        out[i] = static_cast<T>(detail::zmodule_access::residue(in[i]));
+}
+
+// Overloads for any contiguous ranges (std::vector, std::array, spans of
+// non-const elements...), which are just viewed as spans
+template <std::ranges::contiguous_range In, detail::mutable_zmodule_range Out>
+requires std::integral<std::ranges::range_value_t<In>>
+constexpr void reduce_into (const In &in, Out &&out) noexcept {
+    using T = std::ranges::range_value_t<In>;
+    using zm_t = std::ranges::range_value_t<Out>;
+    reduce_into(std::span<const T>{in}, std::span<zm_t>{out});
+}
+
+template <detail::zmodule_range In, std::ranges::contiguous_range Out>
+requires std::integral<std::ranges::range_value_t<Out>> &&
+         std::ranges::output_range<Out, std::ranges::range_value_t<Out>>
+constexpr void lift_from (const In &in, Out &&out) noexcept {
+    using zm_t = std::ranges::range_value_t<In>;
+    using T = std::ranges::range_value_t<Out>;
+    lift_from(std::span<const zm_t>{in}, std::span<T>{out});
+}
+
+}   // namespace fgs
+
+#endif
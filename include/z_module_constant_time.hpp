@@ -0,0 +1,433 @@
+#ifndef Z_MODULE_CONSTANT_TIME_HPP__
+#define Z_MODULE_CONSTANT_TIME_HPP__
+
+#include "z_module.hpp"
+
+#include <bit>          // std::bit_width
+#include <concepts>     // std::integral, std::signed_integral
+#include <cstdint>      // std::int64_t, std::uint32_t, std::uint64_t
+#include <iostream>     // std::basic_istream, std::basic_ostream
+#include <limits>       // std::numeric_limits
+#include <type_traits>  // std::conditional_t, std::make_unsigned_t, std::remove_cvref_t
+
+#ifdef FGS_EXCEPTIONS_SUPPORT
+    #include <stdexcept>    // std::domain_error
+#endif
+
+namespace fgs{
+
+namespace detail{
+    /* Montgomery arithmetic for an odd modulus N, with every operation written
+     * as straight-line code: conditional corrections are masks built from the
+     * borrow of a wider subtraction, never branches or early exits. Values
+     * are kept in Montgomery form x*R mod N, with R = 2^32 or 2^64 depending
+     * on the size of N
+     */
+    template <auto N>
+    struct montgomery_traits{
+        using word = std::conditional_t<(N <= std::numeric_limits<std::uint32_t>::max()),
+                                        std::uint32_t, std::uint64_t>;
+        using wide = wide_t<word>;
+        // Big enough for the divsteps, where |g - f| < 2N
+        using signed_wide = std::conditional_t<std::same_as<word, std::uint32_t>, std::int64_t, int128_t>;
+
+        static constexpr int bits = digits_v<word>;
+        static constexpr word modulus = static_cast<word>(N);
+
+        // N^-1 mod R, by Newton's iteration (N*N = 1 mod 8 gives the first 3 bits)
+        static constexpr word n_inv = [](){
+            word x = modulus;
+            for (int i=0; i<5; ++i)
+                x *= static_cast<word>(2 - modulus*x);
+            return x;
+        }();
+
+        // R^k mod N, to get in and out of Montgomery form
+        static constexpr word r1 = static_cast<word>((wide(1) << bits) % modulus);
+        static constexpr word r2 = static_cast<word>(wide(r1) * r1 % modulus);
+        static constexpr word r3 = static_cast<word>(wide(r2) * r1 % modulus);
+
+        // All ones when x is negative as a signed_wide (or wraps as a wide), zero otherwise
+        static constexpr word borrow_mask (const wide &x) noexcept {
+            return static_cast<word>(x >> bits);
+        }
+        static constexpr word bool_mask (bool b) noexcept {
+            return static_cast<word>(word(0) - static_cast<word>(b));
+        }
+        // All ones when x is negative, by sign extension
+        template <std::signed_integral T>
+        static constexpr word sign_mask (const T &x) noexcept {
+            return static_cast<word>(static_cast<std::int64_t>(x) >> 63);
+        }
+        static constexpr word select (word mask, const word &a, const word &b) noexcept {
+            return b ^ ((a ^ b) & mask);
+        }
+
+        static constexpr word add (const word &a, const word &b) noexcept {
+            const wide s = wide(a) + b - modulus;
+            return static_cast<word>(static_cast<word>(s) + (modulus & borrow_mask(s)));
+        }
+        static constexpr word sub (const word &a, const word &b) noexcept {
+            const wide d = wide(a) - b;
+            return static_cast<word>(static_cast<word>(d) + (modulus & borrow_mask(d)));
+        }
+
+        // x/2 mod N: odd values get N added first, written so it can't overflow
+        static constexpr word half (const word &x) noexcept {
+            return static_cast<word>((x >> 1) + (((modulus >> 1) + 1) & bool_mask(x & 1)));
+        }
+
+        // t*R^-1 mod N, for t < N*R. With m = t*N^-1 mod R the low words of t
+        // and m*N are equal, so (t - m*N)/R is just the difference of the high
+        // words, which lies in (-N, N)
+        static constexpr word redc (const wide &t) noexcept {
+            const word m = static_cast<word>(static_cast<word>(t) * n_inv);
+            const wide d = wide(static_cast<word>(t >> bits)) - static_cast<word>((wide(m) * modulus) >> bits);
+            return static_cast<word>(static_cast<word>(d) + (modulus & borrow_mask(d)));
+        }
+
+        static constexpr word mul (const word &a, const word &b) noexcept {
+            return redc(wide(a) * b);
+        }
+    };
+
+    // All ones in magnitude_t<T> when x is negative, by sign extension. The
+    // words of montgomery_traits may be narrower than T, so their masks can't
+    // be used on the magnitude
+    template <std::signed_integral T>
+    constexpr magnitude_t<T> magnitude_mask(const T &x) noexcept {
+        return static_cast<magnitude_t<T>>(static_cast<std::int64_t>(x) >> 63);
+    }
+}   // namespace detail
+
+// Z-module whose operations take the same time whatever the values involved,
+// for secrets such as keys or nonces. Unlike ZModule, nothing here branches
+// or loops depending on the data:
+//      -Addition, subtraction, increments and decrements correct with masks
+//      -Multiplication is Montgomery's, so elements live in Montgomery form
+//      -Powers run a Montgomery ladder over every bit of the exponent type
+//      -Inverses use Bernstein-Yang's divsteps with a fixed number of steps
+// Montgomery form needs an odd N. Conversions from and to ZModule are
+// explicit, so the fast and constant-time modes can't be mixed by accident
+template <std::integral auto Integer> requires (Integer > 1 && Integer % 2 == 1)
+class constant_time_zmodule{
+    using traits = detail::montgomery_traits<ZModule<Integer>::N>;
+    using word = typename traits::word;
+    using wide = typename traits::wide;
+    using signed_wide = typename traits::signed_wide;
+
+public:
+    using value_type = typename ZModule<Integer>::value_type;
+    static constexpr value_type N = ZModule<Integer>::N;
+
+    // Bernstein-Yang's bound for the divsteps needed with inputs of d bits
+    // (theorem 11.2 of "Fast constant-time gcd computation and modular inversion")
+    static constexpr int divsteps = (std::bit_width(N) < 46)
+        ? (49*std::bit_width(N) + 80) / 17
+        : (49*std::bit_width(N) + 57) / 17;
+
+    constexpr constant_time_zmodule () noexcept = default;
+
+    // Integral values are split in words, and each of them is brought into
+    // Montgomery form with a multiplication by R^2, so there's no division
+    template <std::integral T>
+    explicit constexpr constant_time_zmodule (const T &other) noexcept {
+        using U = detail::magnitude_t<T>;
+        auto magnitude = static_cast<U>(other);
+        word negative = 0;
+        if constexpr (std::signed_integral<T>){
+            negative = traits::sign_mask(other);
+            const U mask = detail::magnitude_mask(other);
+            magnitude = static_cast<U>((magnitude ^ mask) - mask);
+        }
+
+        if constexpr (detail::digits_v<U> <= traits::bits){
+            n = traits::mul(static_cast<word>(magnitude), traits::r2);
+        }
+        else{   // Two 32 bits words: hi*R + lo
+            const auto lo = static_cast<word>(magnitude), hi = static_cast<word>(magnitude >> traits::bits);
+            n = traits::add(traits::mul(hi, traits::r3), traits::mul(lo, traits::r2));
+        }
+        n = traits::select(negative, traits::sub(0, n), n);
+    }
+
+    explicit constexpr constant_time_zmodule (const ZModule<Integer> &zm) noexcept
+        : n{traits::mul(static_cast<word>(static_cast<value_type>(zm)), traits::r2)} {}
+
+    // Increment and decrement operators
+    constexpr constant_time_zmodule& operator++ () noexcept {
+        n = traits::add(n, traits::r1);
+        return *this;
+    }
+    constexpr constant_time_zmodule& operator-- () noexcept {
+        n = traits::sub(n, traits::r1);
+        return *this;
+    }
+    constexpr constant_time_zmodule operator++ (int) noexcept {
+        constant_time_zmodule ret{*this};
+        ++(*this);
+        return ret;
+    }
+    constexpr constant_time_zmodule operator-- (int) noexcept {
+        constant_time_zmodule ret{*this};
+        --(*this);
+        return ret;
+    }
+
+    // Operator overloadings for modular arithmetic
+    constexpr constant_time_zmodule& operator+= (const constant_time_zmodule &zm) noexcept {
+        n = traits::add(n, zm.n);
+        return *this;
+    }
+    constexpr constant_time_zmodule& operator-= (const constant_time_zmodule &zm) noexcept {
+        n = traits::sub(n, zm.n);
+        return *this;
+    }
+    constexpr constant_time_zmodule& operator*= (const constant_time_zmodule &zm) noexcept {
+        n = traits::mul(n, zm.n);
+        return *this;
+    }
+    constexpr constant_time_zmodule& operator/= (const constant_time_zmodule &zm)
+#ifndef FGS_EXCEPTIONS_SUPPORT
+    noexcept
+#endif
+    {
+        return *this *= zm.inverse();
+    }
+
+    // Multiplicative inverse. Without exceptions support, the result for
+    // non invertible values is unspecified. With it, they throw, which only
+    // reveals that the value wasn't a unit
+    [[nodiscard]] constexpr constant_time_zmodule inverse () const
+#ifndef FGS_EXCEPTIONS_SUPPORT
+    noexcept
+#endif
+    {
+        const auto [ret, invertible] = inverse_divsteps();
+#ifdef FGS_EXCEPTIONS_SUPPORT
+        if (!invertible)
+            throw std::domain_error("Non invertible value in " + ZModule<Integer>::NAME);
+#endif
+        static_cast<void>(invertible);
+        return ret;
+    }
+
+    // a if c holds, b otherwise, without branching on c
+    [[nodiscard]] friend constexpr constant_time_zmodule
+    select (bool c, const constant_time_zmodule &a, const constant_time_zmodule &b) noexcept {
+        return from_montgomery_form(traits::select(traits::bool_mask(c), a.n, b.n));
+    }
+
+    // Montgomery ladder: the same squaring and multiplication are done for
+    // every bit of the exponent type, and the bit only decides (with masks)
+    // which variable receives each result. Negative exponents are powers of
+    // the inverse, which is always computed for signed exponent types
+    template <std::integral T>
+    [[nodiscard]] friend constexpr constant_time_zmodule
+    operator^ (const constant_time_zmodule &base, const T &exponent)
+#ifndef FGS_EXCEPTIONS_SUPPORT
+        noexcept
+#endif
+    {
+        using U = detail::magnitude_t<T>;
+        auto e = static_cast<U>(exponent);
+        word b = base.n;
+        if constexpr (std::signed_integral<T>){
+            const word negative = traits::sign_mask(exponent);
+            const U mask = detail::magnitude_mask(exponent);
+            e = static_cast<U>((e ^ mask) - mask);
+
+            const auto [inv, invertible] = base.inverse_divsteps();
+#ifdef FGS_EXCEPTIONS_SUPPORT
+            if (exponent < 0 && !invertible)
+                throw std::domain_error("Non invertible value in " + ZModule<Integer>::NAME);
+#endif
+            static_cast<void>(invertible);
+            b = traits::select(negative, inv.n, b);
+        }
+
+        // Invariant: r1 = r0 * b
+        word r0 = traits::r1, r1 = b;
+        for (int i = detail::digits_v<U>-1; i >= 0; --i){
+            const word swap = traits::bool_mask(static_cast<bool>((e >> i) & 1));
+            conditional_swap(swap, r0, r1);
+            r1 = traits::mul(r0, r1);
+            r0 = traits::mul(r0, r0);
+            conditional_swap(swap, r0, r1);
+        }
+        return from_montgomery_form(r0);
+    }
+
+    // Explicit conversions, leaving Montgomery form
+    template <std::integral T>
+    constexpr explicit operator T () const noexcept {
+        return static_cast<T>(value());
+    }
+    constexpr explicit operator ZModule<Integer> () const noexcept {
+        return assume_reduced<Integer>(value());
+    }
+
+    // Only equality makes sense, the order of the Montgomery forms isn't the
+    // order of the values. Comparing whole words doesn't exit early
+    friend constexpr bool operator== (const constant_time_zmodule&, const constant_time_zmodule&) noexcept = default;
+
+    template <std::integral T>
+    friend constexpr bool operator== (const constant_time_zmodule &lhs, const T &rhs) noexcept {
+        return lhs == constant_time_zmodule(rhs);
+    }
+
+    template <typename CharT, typename Traits>
+    friend std::basic_ostream<CharT, Traits>&
+    operator<< (std::basic_ostream<CharT, Traits> &os, const constant_time_zmodule &zm){
+        return os << zm.value();
+    }
+
+    template <typename CharT, typename Traits>
+    friend std::basic_istream<CharT, Traits>&
+    operator>> (std::basic_istream<CharT, Traits> &is, constant_time_zmodule &zm){
+        ZModule<Integer> tmp;
+        if (is >> tmp)
+            zm = constant_time_zmodule(tmp);
+        return is;
+    }
+
+private:
+    word n{};   // Montgomery form, n = x*R mod N
+
+    static constexpr constant_time_zmodule from_montgomery_form (const word &x) noexcept {
+        constant_time_zmodule ret;
+        ret.n = x;
+        return ret;
+    }
+
+    constexpr value_type value () const noexcept {
+        return static_cast<value_type>(traits::redc(n));
+    }
+
+    static constexpr void conditional_swap (word mask, word &a, word &b) noexcept {
+        const word t = (a ^ b) & mask;
+        a ^= t;
+        b ^= t;
+    }
+
+    struct inverse_result{
+        constant_time_zmodule value;
+        bool invertible;
+    };
+
+    /* Bernstein-Yang divsteps over f = N and g = n (the Montgomery form, as
+     * an integer). Each step is
+     *      delta > 0 and g odd:    (1 - delta, g, (g - f)/2)
+     *      otherwise:              (1 + delta, f, (g + (g mod 2)*f)/2)
+     * and keeps f = d*n, g = e*n (mod N). After `divsteps` steps g = 0 and
+     * f = +-gcd(N, n), so when the gcd is 1, d = +-n^-1 = +-x^-1 R^-1, and
+     * multiplying by R^3 gives x^-1 R, the Montgomery form of the inverse.
+     * Every step runs in full, with the conditions turned into masks
+     */
+    constexpr inverse_result inverse_divsteps () const noexcept {
+        constexpr int sign_shift = detail::digits_v<wide>-1;
+
+        signed_wide delta = 1;
+        signed_wide f = static_cast<signed_wide>(traits::modulus), g = static_cast<signed_wide>(n);
+        word d = 0, e = 1;
+
+        for (int i=0; i<divsteps; ++i){
+            // Both masks are all ones or zero
+            const signed_wide g_odd = -(g & 1);
+            const signed_wide swap = (-delta >> sign_shift) & g_odd;    // delta > 0 and g odd
+            const word swap_w = static_cast<word>(swap), g_odd_w = static_cast<word>(g_odd);
+
+            delta = ((delta ^ swap) - swap) + 1;
+
+            const signed_wide f_old = f;
+            f ^= (f ^ g) & swap;
+            g = (g + (((f_old ^ swap) - swap) & g_odd)) >> 1;   // Exact, the sum is even
+
+            const word d_old = d;
+            d = traits::select(swap_w, e, d);
+            e = traits::select(g_odd_w, traits::select(swap_w, traits::sub(e, d_old), traits::add(e, d_old)), e);
+            e = traits::half(e);
+        }
+
+        // f = -1 flips the sign of d
+        const word negative = static_cast<word>(f >> sign_shift);
+        d = traits::select(negative, traits::sub(0, d), d);
+        const bool invertible = ((f ^ (f >> sign_shift)) - (f >> sign_shift)) == 1;
+        return {from_montgomery_form(traits::mul(d, traits::r3)), invertible};
+    }
+};
+
+// Unary + and - operators
+template<auto Integer>
+constexpr constant_time_zmodule<Integer> operator+ (const constant_time_zmodule<Integer> &rhs) noexcept {
+    return rhs;
+}
+template<auto Integer>
+constexpr constant_time_zmodule<Integer> operator- (const constant_time_zmodule<Integer> &rhs) noexcept {
+    return constant_time_zmodule<Integer>{} -= rhs;
+}
+
+// Binary operators, also with integral values on any side
+template<auto Integer>
+constexpr constant_time_zmodule<Integer> operator+ (constant_time_zmodule<Integer> lhs,
+                                                    const constant_time_zmodule<Integer> &rhs) noexcept {
+    return lhs += rhs;
+}
+template<auto Integer>
+constexpr constant_time_zmodule<Integer> operator- (constant_time_zmodule<Integer> lhs,
+                                                    const constant_time_zmodule<Integer> &rhs) noexcept {
+    return lhs -= rhs;
+}
+template<auto Integer>
+constexpr constant_time_zmodule<Integer> operator* (constant_time_zmodule<Integer> lhs,
+                                                    const constant_time_zmodule<Integer> &rhs) noexcept {
+    return lhs *= rhs;
+}
+template<auto Integer>
+constexpr constant_time_zmodule<Integer> operator/ (constant_time_zmodule<Integer> lhs,
+                                                    const constant_time_zmodule<Integer> &rhs)
+#ifndef FGS_EXCEPTIONS_SUPPORT
+    noexcept
+#endif
+{
+    return lhs /= rhs;
+}
+/*------------------------------------------*/
+template<auto Integer, std::integral T>
+constexpr constant_time_zmodule<Integer> operator+ (constant_time_zmodule<Integer> lhs, const T &rhs) noexcept {
+    return lhs += constant_time_zmodule<Integer>(rhs);
+}
+template<auto Integer, std::integral T>
+constexpr constant_time_zmodule<Integer> operator- (constant_time_zmodule<Integer> lhs, const T &rhs) noexcept {
+    return lhs -= constant_time_zmodule<Integer>(rhs);
+}
+template<auto Integer, std::integral T>
+constexpr constant_time_zmodule<Integer> operator* (constant_time_zmodule<Integer> lhs, const T &rhs) noexcept {
+    return lhs *= constant_time_zmodule<Integer>(rhs);
+}
+template<auto Integer, std::integral T>
+constexpr constant_time_zmodule<Integer> operator+ (const T &lhs, const constant_time_zmodule<Integer> &rhs) noexcept {
+    return constant_time_zmodule<Integer>(lhs) += rhs;
+}
+template<auto Integer, std::integral T>
+constexpr constant_time_zmodule<Integer> operator- (const T &lhs, const constant_time_zmodule<Integer> &rhs) noexcept {
+    return constant_time_zmodule<Integer>(lhs) -= rhs;
+}
+template<auto Integer, std::integral T>
+constexpr constant_time_zmodule<Integer> operator* (const T &lhs, const constant_time_zmodule<Integer> &rhs) noexcept {
+    return constant_time_zmodule<Integer>(lhs) *= rhs;
+}
+
+// Type trait to check if some type is a constant-time z-module
+template <typename T>
+inline constexpr bool is_constant_time_z_module = false;
+template <auto Integer>
+inline constexpr bool is_constant_time_z_module<constant_time_zmodule<Integer>> = true;
+
+// Shorter name, following Z<n>
+template<auto Integer>
+using Z_ct = constant_time_zmodule<Integer>;
+
+}   // namespace fgs
+
+#endif
@@ -0,0 +1,393 @@
+#ifndef Z_MODULE_CRT_HPP__
+#define Z_MODULE_CRT_HPP__
+
+#include "z_module.hpp"
+#include "detail/factorization.hpp"
+#include "detail/parallel.hpp"
+
+#include <array>        // std::array
+#include <cstddef>      // std::size_t
+#include <cstdint>      // std::uint32_t, std::uint64_t
+#include <limits>       // std::numeric_limits
+#include <optional>     // std::optional, std::nullopt
+#include <span>         // std::span
+#include <tuple>        // std::tuple, std::get
+#include <type_traits>  // std::integral_constant, std::remove_cvref_t
+#include <utility>      // std::forward, std::index_sequence, std::make_index_sequence
+#include <vector>       // std::vector
+
+namespace fgs{
+
+namespace detail{
+    // Quadratic non-residue and 2-adic decomposition P-1 = q*2^s of an odd prime
+    template <auto P>
+    struct quadratic_traits{
+        using zm_t = ZModule<P>;
+        using value_type = typename zm_t::value_type;
+
+        static constexpr int s = [](){
+            int ret = 0;
+            for (value_type t = zm_t::N-1; t%2 == 0; t /= 2)
+                ++ret;
+            return ret;
+        }();
+        static constexpr value_type q = (zm_t::N-1) >> s;
+
+        static constexpr zm_t non_residue = [](){
+            zm_t z(2u);
+            while ((z ^ ((zm_t::N-1)/2)) == 1u)
+                ++z;
+            return z;
+        }();
+    };
+
+    // Square root modulo a prime (Tonelli-Shanks), if x is a quadratic residue
+    template <auto P>
+    constexpr std::optional<ZModule<P>> sqrt_mod_prime (const ZModule<P> &x) noexcept {
+        using zm_t = ZModule<P>;
+
+        if constexpr (zm_t::N == 2){
+            return x;
+        }
+        else{
+            using traits = quadratic_traits<P>;
+
+            if (x == 0u)
+                return x;
+            if ((x ^ ((zm_t::N-1)/2)) != 1u)    // Euler's criterion
+                return std::nullopt;
+            if constexpr (traits::s == 1)
+                return x ^ ((zm_t::N+1)/4);
+
+            // Invariant: r^2 = x*t, with t of order 2^i for some i < m
+            int m = traits::s;
+            zm_t c = traits::non_residue ^ traits::q;
+            zm_t t = x ^ traits::q;
+            zm_t r = x ^ ((traits::q+1)/2);
+            while (t != 1u){
+                int i = 0;
+                for (zm_t t2=t; t2 != 1u; t2 *= t2)
+                    ++i;
+
+                zm_t b = c;
+                for (int j=0; j<m-i-1; ++j)
+                    b *= b;
+
+                m = i;
+                c = b*b;
+                t *= c;
+                r *= b;
+            }
+            return r;
+        }
+    }
+
+    /* Square root modulo Q = P^E. With x = P^v * u (u a unit), a root exists
+     * iff v is even and u is a square modulo P^(E-v), and then P^(v/2) times
+     * any root of u is a root of x. Roots of units are lifted from P with
+     * Newton's iteration s <- (s + u/s)/2, which doubles the precision each
+     * step. For P = 2 the lifting is done bit by bit, since 2 is not invertible
+     */
+    template <auto P, int E, auto Q>
+    constexpr std::optional<ZModule<Q>> sqrt_mod_prime_power (const ZModule<Q> &x) noexcept {
+        using zm_t = ZModule<Q>;
+        using value_type = typename zm_t::value_type;
+        constexpr value_type p = static_cast<value_type>(P);
+
+        auto u = static_cast<value_type>(x);
+        if (u == 0)
+            return x;
+
+        int v = 0;
+        value_type p_half = 1;      // P^(v/2)
+        for (; u%p == 0; u /= p){
+            if (v%2 == 1)
+                p_half *= p;
+            ++v;
+        }
+        if (v%2 == 1)
+            return std::nullopt;
+
+        const int e = E - v;        // Precision needed for the root of u
+        const zm_t zu = assume_reduced<Q>(u);
+        zm_t s(1u);
+
+        if constexpr (P == 2){
+            if ((e >= 2 && u%4 != 1) || (e >= 3 && u%8 != 1))
+                return std::nullopt;
+
+            // s^2 = u (mod 2^k) implies s^2 = u (mod 2^(k+1)) for s or s + 2^(k-1)
+            for (int k=3; k<e; ++k){
+                const auto diff = static_cast<value_type>(s*s - zu);
+                if ((diff >> k) & 1u)
+                    s += assume_reduced<Q>(value_type(1) << (k-1));
+            }
+        }
+        else{
+            const auto root = sqrt_mod_prime<p>(ZModule<p>(u));
+            if (!root)
+                return std::nullopt;
+
+            s = assume_reduced<Q>(static_cast<value_type>(*root));
+            const zm_t half = assume_reduced<Q>((zm_t::N+1)/2);
+            for (int precision=1; precision<e; precision*=2)
+                s = (s + zu/s) * half;
+        }
+        return s * assume_reduced<Q>(p_half);
+    }
+}   // namespace detail
+
+// View of Z<N> as the product of the rings Z<p^e> for the prime powers of N
+// (Chinese Remainder Theorem). N is factored at compile time, and both the
+// components and the recombination constants are compile-time values.
+//
+// Element-wise, decompose() and recombine() move between both forms, and
+// inverses and square roots are computed per component. crt_view::vector
+// holds whole arrays in that form, one contiguous array per component, so
+// bulk operations run on narrower moduli and in parallel
+template <std::integral auto Integer> requires (Integer > 1)
+class crt_view{
+    using modulus_type = typename ZModule<Integer>::value_type;
+    static_assert(detail::digits_v<modulus_type> <= 64, "Only moduli up to 64 bits can be factored");
+
+    static constexpr detail::factorization factors = detail::factorize(ZModule<Integer>::N);
+
+public:
+    using value_type = ZModule<Integer>;
+    using size_type  = std::size_t;
+
+    static constexpr size_type components = factors.count;
+
+    // p_i, e_i and p_i^e_i, in increasing order of p_i
+    static constexpr auto primes = [](){
+        std::array<modulus_type, components> ret{};
+        for (size_type i=0; i<components; ++i)
+            ret[i] = static_cast<modulus_type>(factors.primes[i]);
+        return ret;
+    }();
+    static constexpr auto exponents = [](){
+        std::array<int, components> ret{};
+        for (size_type i=0; i<components; ++i)
+            ret[i] = factors.exponents[i];
+        return ret;
+    }();
+    static constexpr auto moduli = [](){
+        std::array<modulus_type, components> ret{};
+        for (size_type i=0; i<components; ++i)
+            ret[i] = static_cast<modulus_type>(factors.powers[i]);
+        return ret;
+    }();
+
+    // Components are stored in the narrowest type whose products still fit
+    // in 64 bits, so their arithmetic doesn't need 128 bits
+    template <size_type I>
+    static constexpr auto component_modulus = [](){
+        if constexpr (moduli[I] <= std::numeric_limits<std::uint32_t>::max())
+            return static_cast<std::uint32_t>(moduli[I]);
+        else
+            return moduli[I];
+    }();
+
+    template <size_type I>
+    using component_type = ZModule<component_modulus<I>>;
+
+private:
+    template <typename Sequence>
+    struct tuple_of;
+    template <size_type... I>
+    struct tuple_of<std::index_sequence<I...>>{
+        using type = std::tuple<component_type<I>...>;
+        using vectors = std::tuple<std::vector<component_type<I>>...>;
+    };
+
+    using indices = std::make_index_sequence<components>;
+
+    // e_i = 1 (mod p_i^e_i) and 0 modulo the rest, so x = sum of x_i * e_i
+    static constexpr auto idempotents = []<size_type... I>(std::index_sequence<I...>){
+        const auto idempotent = []<size_type J>(std::integral_constant<size_type, J>){
+            // Plain Euclid: ZModule's inverse would check primality in constant evaluation
+            const modulus_type cofactor = value_type::N / moduli[J];
+            const auto inverse = static_cast<modulus_type>(detail::inverse_mod64(cofactor, moduli[J]));
+            return mul_const<Integer>{value_type(cofactor) * value_type(inverse)};
+        };
+        return std::array<mul_const<Integer>, components>{
+            idempotent(std::integral_constant<size_type, I>{})...
+        };
+    }(indices{});
+
+public:
+    using tuple_type = typename tuple_of<indices>::type;
+
+    [[nodiscard]] static constexpr tuple_type decompose (const value_type &x) noexcept {
+        const auto n = static_cast<modulus_type>(x);
+        return [&]<size_type... I>(std::index_sequence<I...>){
+            return tuple_type{component_type<I>(n)...};
+        }(indices{});
+    }
+
+    [[nodiscard]] static constexpr value_type recombine (const tuple_type &t) noexcept {
+        return [&]<size_type... I>(std::index_sequence<I...>){
+            return (value_type(0u) + ... + (
+                assume_reduced<Integer>(static_cast<modulus_type>(std::get<I>(t))) * idempotents[I]
+            ));
+        }(indices{});
+    }
+
+    // Whether x is invertible, without any gcd: it has to be non zero modulo every p_i
+    [[nodiscard]] static constexpr bool is_unit (const value_type &x) noexcept {
+        const auto n = static_cast<modulus_type>(x);
+        for (const auto p : primes)
+            if (n % p == 0)
+                return false;
+        return true;
+    }
+
+    // Inverse of x, computed in every component. Same requirements as operator/
+    [[nodiscard]] static constexpr value_type inverse (const value_type &x)
+#ifndef FGS_EXCEPTIONS_SUPPORT
+    noexcept
+#endif
+    {
+        const auto t = decompose(x);
+        return [&]<size_type... I>(std::index_sequence<I...>){
+            return recombine(tuple_type{component_type<I>(1u) / std::get<I>(t)...});
+        }(indices{});
+    }
+
+    // Some square root of x, if there's any. Roots are found in every
+    // component and then recombined
+    [[nodiscard]] static constexpr std::optional<value_type> sqrt (const value_type &x) noexcept {
+        const auto t = decompose(x);
+        return [&]<size_type... I>(std::index_sequence<I...>) -> std::optional<value_type> {
+            const auto roots = std::tuple{
+                detail::sqrt_mod_prime_power<primes[I], exponents[I], component_modulus<I>>(std::get<I>(t))...
+            };
+            if (!(std::get<I>(roots) && ...))
+                return std::nullopt;
+            return recombine(tuple_type{*std::get<I>(roots)...});
+        }(indices{});
+    }
+
+    // Array of z-modules stored by components. Every component is processed
+    // by its own thread, and big arrays are recombined in parallel chunks
+    class vector{
+    public:
+        vector () = default;
+
+        explicit vector (std::span<const value_type> values)
+            : n{values.size()}
+        {
+            for_each_vector([&](auto &c){
+                using zm_t = typename std::remove_cvref_t<decltype(c)>::value_type;
+                c.resize(n);
+                for (size_type i=0; i<n; ++i)
+                    c[i] = zm_t(static_cast<modulus_type>(values[i]));
+            });
+        }
+
+        [[nodiscard]] size_type size () const noexcept { return n; }
+
+        template <size_type I>
+        [[nodiscard]] std::span<component_type<I>> component () noexcept {
+            return std::get<I>(data);
+        }
+        template <size_type I>
+        [[nodiscard]] std::span<const component_type<I>> component () const noexcept {
+            return std::get<I>(data);
+        }
+
+        // out[i] = i-th element back in Z<N>. Sizes must match
+        void recombine (std::span<value_type> out) const {
+            detail::parallel_for(n, [&](size_type lo, size_type hi){
+                for (size_type i=lo; i<hi; ++i){
+                    out[i] = [&]<size_type... I>(std::index_sequence<I...>){
+                        return (value_type(0u) + ... + (
+                            assume_reduced<Integer>(static_cast<modulus_type>(std::get<I>(data)[i])) * idempotents[I]
+                        ));
+                    }(indices{});
+                }
+            });
+        }
+
+        [[nodiscard]] std::vector<value_type> values () const {
+            std::vector<value_type> ret(n);
+            recombine(ret);
+            return ret;
+        }
+
+        // Element-wise arithmetic. Sizes must match
+        vector& operator+= (const vector &v){
+            return zip(v, [](auto &a, const auto &b){ a += b; });
+        }
+        vector& operator-= (const vector &v){
+            return zip(v, [](auto &a, const auto &b){ a -= b; });
+        }
+        vector& operator*= (const vector &v){
+            return zip(v, [](auto &a, const auto &b){ a *= b; });
+        }
+
+        friend vector operator+ (vector lhs, const vector &rhs){ return lhs += rhs; }
+        friend vector operator- (vector lhs, const vector &rhs){ return lhs -= rhs; }
+        friend vector operator* (vector lhs, const vector &rhs){ return lhs *= rhs; }
+
+        // Replaces every element by its inverse. Each component uses
+        // Montgomery's trick (a single inversion plus three products per
+        // element), so every element has to be invertible
+        vector& invert (){
+            for_each_vector([&](auto &c){
+                using zm_t = typename std::remove_cvref_t<decltype(c)>::value_type;
+                if (c.empty())
+                    return;
+
+                std::vector<zm_t> prefix(c.size());
+                prefix[0] = c[0];
+                for (size_type i=1; i<c.size(); ++i)
+                    prefix[i] = prefix[i-1] * c[i];
+
+                zm_t inv = zm_t(1u) / prefix.back();
+                for (size_type i=c.size(); i-- > 1; ){
+                    const zm_t ci = c[i];
+                    c[i] = inv * prefix[i-1];
+                    inv *= ci;
+                }
+                c[0] = inv;
+            });
+            return *this;
+        }
+
+        // Calls f(std::span<component_type<I>>) for every component, each
+        // one in its own thread when the array is big enough. Spans let the
+        // elements change but not the sizes, which must all stay equal to n
+        template <typename F>
+        void for_each_component (F &&f){
+            for_each_vector([&](auto &c){ f(std::span(c)); });
+        }
+
+    private:
+        typename tuple_of<indices>::vectors data;
+        size_type n = 0;
+
+        // Same as for_each_component, with the vectors themselves
+        template <typename F>
+        void for_each_vector (F &&f){
+            detail::parallel_invoke<components>(n >= detail::parallel_grain && components > 1, [&](auto index){
+                f(std::get<decltype(index)::value>(data));
+            });
+        }
+
+        template <typename F>
+        vector& zip (const vector &v, F &&op){
+            detail::parallel_invoke<components>(n >= detail::parallel_grain, [&](auto index){
+                auto &a = std::get<decltype(index)::value>(data);
+                const auto &b = std::get<decltype(index)::value>(v.data);
+                for (size_type i=0; i<a.size(); ++i)
+                    op(a[i], b[i]);
+            });
+            return *this;
+        }
+    };
+};
+
+}   // namespace fgs
+
+#endif
@@ -0,0 +1,606 @@
+#ifndef Z_MODULE_POLYNOMIAL_HPP__
+#define Z_MODULE_POLYNOMIAL_HPP__
+
+#include "z_module.hpp"
+
+#include <algorithm>        // std::max, std::min, std::reverse
+#include <array>            // std::array
+#include <bit>              // std::bit_width
+#include <cstddef>          // std::size_t, std::ptrdiff_t
+#include <cstdint>          // std::uint32_t, std::uint64_t, std::int64_t
+#include <initializer_list> // std::initializer_list
+#include <mutex>            // std::call_once, std::once_flag
+#include <span>             // std::span
+#include <tuple>            // std::tuple, std::get
+#include <utility>          // std::index_sequence, std::move, std::pair, std::swap
+#include <vector>           // std::vector
+
+namespace fgs{
+
+namespace detail{
+    // Below these sizes the quadratic algorithms are faster
+    inline constexpr std::size_t naive_multiplication_threshold = 32;
+    inline constexpr std::size_t naive_division_threshold = 64;
+    inline constexpr std::size_t naive_evaluation_threshold = 64;
+    // Multi-modular multiplication needs several transforms, so Karatsuba
+    // is faster for medium sizes
+    inline constexpr std::size_t crt_multiplication_threshold = 512;
+
+    /* Number Theoretic Transform support for a prime P = 2^s * t + 1 (t odd).
+     *
+     * A root of unity of order 2^s is a^t for any quadratic non-residue a,
+     * which we find trying small candidates; this way there's no need to
+     * factor P-1. Transforms up to length 2^s are possible.
+     */
+    template <auto P>
+    struct ntt_traits{
+        using zm_t = ZModule<P>;
+        using value_type = typename zm_t::value_type;
+
+        static constexpr int s = [](){
+            int ret = 0;
+            for (value_type t = zm_t::N-1; t%2 == 0; t /= 2)
+                ++ret;
+            return ret;
+        }();
+
+        // Maximum transform length, 2^log_max_size
+        static constexpr int log_max_size = (s < 30) ? s : 30;
+        static constexpr std::size_t max_size = std::size_t(1) << log_max_size;
+
+        // Root of unity of order exactly max_size
+        static constexpr zm_t root = [](){
+            const value_type t = (zm_t::N-1) >> s;
+            for (value_type a=2; ; ++a){
+                const zm_t w = zm_t(a) ^ t;
+                // The order of w is exactly 2^s iff w^(2^(s-1)) = -1
+                zm_t x = w;
+                for (int i=1; i<s; ++i)
+                    x *= x;
+                if (x == zm_t::N-1){
+                    zm_t ret = w;
+                    for (int i=log_max_size; i<s; ++i)
+                        ret *= ret;
+                    return ret;
+                }
+            }
+        }();
+
+        // roots[k] has order exactly 2^k, and inverse_sizes[k] = 2^-k
+        static constexpr std::array<zm_t, log_max_size+1> roots = [](){
+            std::array<zm_t, log_max_size+1> ret;
+            ret[log_max_size] = root;
+            for (int k=log_max_size; k>0; --k)
+                ret[k-1] = ret[k] * ret[k];
+            return ret;
+        }();
+        static constexpr std::array<zm_t, log_max_size+1> inverse_sizes = [](){
+            std::array<zm_t, log_max_size+1> ret;
+            ret[0] = zm_t(1u);
+            const zm_t half = zm_t(1u) / zm_t(2u);
+            for (int k=1; k<=log_max_size; ++k)
+                ret[k] = ret[k-1] * half;
+            return ret;
+        }();
+    };
+
+    /* Twiddle factors of the stage of length 2^l of a transform, with their
+     * Shoup constants: w^j (j < 2^(l-1)) for w of order 2^l. They don't depend
+     * on the length of the transform, so every level is built once, on first
+     * use, shared by every transform and every thread, and the whole cache is
+     * never bigger than the table of the longest transform
+     */
+    template <auto P>
+    std::span<const mul_const<P>> ntt_twiddles(int l){
+        using zm_t = ZModule<P>;
+        using traits = ntt_traits<P>;
+
+        static std::array<std::vector<mul_const<P>>, traits::log_max_size+1> levels;
+        static std::array<std::once_flag, traits::log_max_size+1> built;
+
+        std::call_once(built[l], [l](){
+            auto &level = levels[l];
+            level.resize(std::size_t(1) << (l-1));
+            zm_t wj(1u);
+            for (auto &e : level){
+                e = mul_const<P>{wj};
+                wj *= traits::roots[l];
+            }
+        });
+        return levels[l];
+    }
+
+    // The search of a root of unity in ntt_traits only ends for primes, so
+    // composite moduli go to the other algorithms even if 2^8 divides P-1
+    template <auto P>
+    inline constexpr bool ntt_friendly = ntt_traits<P>::s >= 8 && is_prime64(P);
+
+    // In-place iterative NTT of length a power of two, with the cached
+    // twiddle factors of ntt_twiddles. The inverse transform is the forward
+    // one followed by reversing a[1..n) (w^-ij = w^(i(n-j))) and scaling by 1/n
+    template <auto P>
+    void ntt(std::vector<ZModule<P>> &a, bool inverse){
+        using zm_t = ZModule<P>;
+        using traits = ntt_traits<P>;
+        const std::size_t n = a.size();
+        const int log_n = std::bit_width(n) - 1;
+
+        // Bit reversal permutation
+        for (std::size_t i=1, j=0; i<n; ++i){
+            std::size_t bit = n >> 1;
+            for (; j & bit; bit >>= 1)
+                j ^= bit;
+            j ^= bit;
+            if (i < j)
+                std::swap(a[i], a[j]);
+        }
+
+        for (int l=1; l<=log_n; ++l){
+            const std::size_t half = std::size_t(1) << (l-1);
+            const mul_const<P> *w = ntt_twiddles<P>(l).data();
+            for (std::size_t i=0; i<n; i+=2*half){
+                for (std::size_t j=0; j<half; ++j){
+                    const zm_t u = a[i+j];
+                    const zm_t v = a[i+j+half] * w[j];
+                    a[i+j] = u + v;
+                    a[i+j+half] = u - v;
+                }
+            }
+        }
+
+        if (inverse){
+            std::reverse(a.begin() + 1, a.end());
+            const mul_const<P> n_inv{traits::inverse_sizes[log_n]};
+            for (auto &e : a)
+                e *= n_inv;
+        }
+    }
+
+    template <auto P>
+    std::vector<ZModule<P>> multiply_naive(std::span<const ZModule<P>> a,
+                                           std::span<const ZModule<P>> b)
+    {
+        std::vector<ZModule<P>> ret(a.size() + b.size() - 1);
+        for (std::size_t i=0; i<a.size(); ++i){
+            const mul_const<P> ai{a[i]};
+            for (std::size_t j=0; j<b.size(); ++j)
+                ret[i+j] += b[j] * ai;
+        }
+        return ret;
+    }
+
+    template <auto P>
+    std::vector<ZModule<P>> multiply_karatsuba(std::span<const ZModule<P>> a,
+                                               std::span<const ZModule<P>> b)
+    {
+        if (a.size() < b.size())
+            std::swap(a, b);
+        if (b.size() <= naive_multiplication_threshold)
+            return multiply_naive(a, b);
+
+        // Very unbalanced operands are multiplied by blocks
+        const std::size_t m = (a.size() + 1) / 2;
+        if (b.size() <= m){
+            std::vector<ZModule<P>> ret(a.size() + b.size() - 1);
+            for (std::size_t i=0; i<a.size(); i+=b.size()){
+                const auto block = a.subspan(i, std::min(b.size(), a.size()-i));
+                const auto partial = multiply_karatsuba(block, b);
+                for (std::size_t j=0; j<partial.size(); ++j)
+                    ret[i+j] += partial[j];
+            }
+            return ret;
+        }
+
+        // a = a0 + x^m a1, b = b0 + x^m b1
+        const auto a0 = a.first(m), a1 = a.subspan(m);
+        const auto b0 = b.first(m), b1 = b.subspan(m);
+
+        std::vector<ZModule<P>> sa(a0.begin(), a0.end()), sb(b0.begin(), b0.end());
+        for (std::size_t i=0; i<a1.size(); ++i) sa[i] += a1[i];
+        for (std::size_t i=0; i<b1.size(); ++i) sb[i] += b1[i];
+
+        const auto z0 = multiply_karatsuba(a0, b0);
+        const auto z2 = multiply_karatsuba(a1, b1);
+        auto z1 = multiply_karatsuba<P>(sa, sb);
+        for (std::size_t i=0; i<z0.size(); ++i) z1[i] -= z0[i];
+        for (std::size_t i=0; i<z2.size(); ++i) z1[i] -= z2[i];
+
+        std::vector<ZModule<P>> ret(a.size() + b.size() - 1);
+        for (std::size_t i=0; i<z0.size(); ++i) ret[i] += z0[i];
+        for (std::size_t i=0; i<z1.size() && m+i < ret.size(); ++i) ret[m+i] += z1[i];
+        for (std::size_t i=0; i<z2.size(); ++i) ret[2*m+i] += z2[i];
+        return ret;
+    }
+
+    /* Multi-modular multiplication for moduli which don't support NTT: the
+     * exact integer product is computed modulo several NTT primes and then
+     * recombined with Garner's algorithm directly modulo P.
+     *
+     * The primes are sorted by size, and all of them allow transforms of
+     * length up to 2^23. crt_bits holds floor(log2) of their cumulative products
+     */
+    inline constexpr std::array<std::uint32_t, 6> crt_primes{
+        2013265921u, 1811939329u, 998244353u, 754974721u, 469762049u, 167772161u
+    };
+    inline constexpr std::array<int, 6> crt_bits{30, 61, 91, 121, 149, 177};
+    inline constexpr std::size_t crt_max_size = std::size_t(1) << 23;
+
+    // Coefficients of the product are smaller than 2^23 * (P-1)^2
+    template <auto P>
+    inline constexpr std::size_t crt_primes_needed = [](){
+        const int needed = 2*std::bit_width(ZModule<P>::N) + 23;
+        std::size_t k = 0;
+        while (crt_bits[k] < needed)
+            ++k;
+        return k+1;
+    }();
+
+    // Cyclic convolution of length n of a and b, taken modulo M
+    template <auto M, auto P>
+    std::vector<ZModule<M>> convolution_in(std::span<const ZModule<P>> a,
+                                           std::span<const ZModule<P>> b,
+                                           std::size_t n)
+    {
+        using value_type = typename ZModule<P>::value_type;
+        std::vector<ZModule<M>> fa(n), fb(n);
+        for (std::size_t i=0; i<a.size(); ++i) fa[i] = ZModule<M>(static_cast<value_type>(a[i]));
+        for (std::size_t i=0; i<b.size(); ++i) fb[i] = ZModule<M>(static_cast<value_type>(b[i]));
+
+        ntt(fa, false);
+        ntt(fb, false);
+        for (std::size_t i=0; i<n; ++i)
+            fa[i] *= fb[i];
+        ntt(fa, true);
+        return fa;
+    }
+
+    template <auto P, std::size_t... I>
+    std::vector<ZModule<P>> multiply_crt(std::span<const ZModule<P>> a,
+                                         std::span<const ZModule<P>> b,
+                                         std::size_t n,
+                                         std::index_sequence<I...>)
+    {
+        constexpr std::size_t K = sizeof...(I);
+
+        // inverses[i][j] = m_j^-1 (mod m_i), for j < i
+        constexpr auto inverses = [](){
+            std::array<std::array<std::uint64_t, K>, K> ret{};
+            for (std::size_t i=0; i<K; ++i)
+                for (std::size_t j=0; j<i; ++j)
+                    ret[i][j] = inverse_mod64(crt_primes[j], crt_primes[i]);
+            return ret;
+        }();
+
+        // Products m_0 * ... * m_{i-1} (mod P)
+        std::array<ZModule<P>, K> prefix;
+        prefix[0] = ZModule<P>(1u);
+        for (std::size_t i=1; i<K; ++i)
+            prefix[i] = prefix[i-1] * ZModule<P>(crt_primes[i-1]);
+
+        const std::tuple residues{convolution_in<crt_primes[I]>(a, b, n)...};
+
+        std::vector<ZModule<P>> ret(a.size() + b.size() - 1);
+        for (std::size_t c=0; c<ret.size(); ++c){
+            // Mixed radix representation: x = t_0 + t_1*m_0 + t_2*m_0*m_1 + ...
+            std::array<std::uint64_t, K> t{
+                static_cast<std::uint64_t>(std::get<I>(residues)[c])...
+            };
+            for (std::size_t i=1; i<K; ++i){
+                const std::uint64_t m = crt_primes[i];
+                for (std::size_t j=0; j<i; ++j)
+                    t[i] = (t[i] + m - t[j] % m) * inverses[i][j] % m;
+            }
+
+            for (std::size_t i=0; i<K; ++i)
+                ret[c] += ZModule<P>(t[i]) * prefix[i];
+        }
+        return ret;
+    }
+
+    // Product of two polynomials given by their coefficients. Schoolbook for
+    // small sizes, NTT for friendly primes and multi-modular NTT or Karatsuba
+    // otherwise
+    template <auto P>
+    std::vector<ZModule<P>> multiply(std::span<const ZModule<P>> a,
+                                     std::span<const ZModule<P>> b)
+    {
+        if (a.empty() || b.empty())
+            return {};
+        if (std::min(a.size(), b.size()) <= naive_multiplication_threshold)
+            return multiply_naive(a, b);
+
+        const std::size_t size = a.size() + b.size() - 1;
+        std::size_t n = 1;
+        while (n < size)
+            n <<= 1;
+
+        if constexpr (ntt_friendly<P>){
+            if (n <= ntt_traits<P>::max_size){
+                std::vector<ZModule<P>> fa(a.begin(), a.end()), fb(b.begin(), b.end());
+                fa.resize(n); fb.resize(n);
+                ntt(fa, false);
+                ntt(fb, false);
+                for (std::size_t i=0; i<n; ++i)
+                    fa[i] *= fb[i];
+                ntt(fa, true);
+                fa.resize(size);
+                return fa;
+            }
+        }
+
+        if (std::min(a.size(), b.size()) > crt_multiplication_threshold && n <= crt_max_size)
+            return multiply_crt(a, b, n, std::make_index_sequence<crt_primes_needed<P>>{});
+
+        return multiply_karatsuba(a, b);
+    }
+}   // namespace detail
+
+// Polynomials with coefficients in Z<P>. Most operations need P to be prime.
+//
+// Multiplication is subquadratic (NTT when P is a prime and P-1 is divisible
+// by a big enough power of two, NTT modulo several primes plus CRT otherwise, and Karatsuba
+// for medium sizes or beyond the lengths those allow), and division,
+// multipoint evaluation and interpolation are built on top of it
+template <std::integral auto P> requires (P > 1)
+class polynomial{
+public:
+    using value_type = ZModule<P>;
+    using size_type  = std::size_t;
+
+    polynomial () = default;
+
+    polynomial (std::initializer_list<value_type> coeffs)
+        : c(coeffs) { normalize(); }
+
+    // Coefficients in increasing degree order
+    explicit polynomial (std::vector<value_type> coeffs)
+        : c(std::move(coeffs)) { normalize(); }
+
+    // Degree of the polynomial (-1 for the zero polynomial)
+    [[nodiscard]] std::ptrdiff_t degree () const noexcept {
+        return static_cast<std::ptrdiff_t>(c.size()) - 1;
+    }
+
+    [[nodiscard]] size_type size () const noexcept { return c.size(); }
+    [[nodiscard]] bool is_zero () const noexcept { return c.empty(); }
+    [[nodiscard]] const std::vector<value_type>& coefficients () const noexcept { return c; }
+
+    // Coefficient of x^i, zero past the degree
+    [[nodiscard]] value_type operator[] (size_type i) const noexcept {
+        return (i < c.size()) ? c[i] : value_type{};
+    }
+
+    // Horner evaluation
+    [[nodiscard]] value_type operator() (const value_type &x) const noexcept {
+        value_type ret{};
+        for (auto it=c.rbegin(); it!=c.rend(); ++it)
+            ret = ret*x + *it;
+        return ret;
+    }
+
+    // Evaluation at many points, using a subproduct tree for big inputs
+    [[nodiscard]] std::vector<value_type> evaluate (std::span<const value_type> points) const {
+        std::vector<value_type> ret(points.size());
+        if (points.size() <= detail::naive_evaluation_threshold){
+            for (size_type i=0; i<points.size(); ++i)
+                ret[i] = (*this)(points[i]);
+        }
+        else{
+            const subproduct_tree tree(points);
+            tree.evaluate(*this % tree.root(), 1, 0, points.size(), ret);
+        }
+        return ret;
+    }
+
+    // Unique polynomial of degree < n with p(xs[i]) = ys[i]. Points must be distinct
+    [[nodiscard]] static polynomial interpolate (std::span<const value_type> xs,
+                                                 std::span<const value_type> ys)
+    {
+        if (xs.empty())
+            return {};
+
+        const subproduct_tree tree(xs);
+
+        // Lagrange weights: ys[i] / M'(xs[i]), with M the product of all (x - xs[i])
+        std::vector<value_type> weights(xs.size());
+        tree.evaluate(tree.root().derivative(), 1, 0, xs.size(), weights);
+        for (size_type i=0; i<xs.size(); ++i)
+            weights[i] = ys[i] / weights[i];
+
+        return tree.combine(weights, 1, 0, xs.size());
+    }
+
+    // First n coefficients of 1/p as a power series (Newton iteration).
+    // The constant term must be invertible
+    [[nodiscard]] polynomial inverse_series (size_type n) const {
+        std::vector<value_type> g{value_type(1u) / (*this)[0]};
+
+        for (size_type k=1; k<n; k*=2){
+            // g <- g*(2 - f*g) mod x^{2k}
+            const size_type m = std::min(2*k, n);
+            std::vector<value_type> f(c.begin(), c.begin() + static_cast<std::ptrdiff_t>(std::min(m, c.size())));
+
+            auto fg = detail::multiply<P>(f, g);
+            fg.resize(m);
+            for (auto &e : fg)
+                e = -e;
+            fg[0] += value_type(2u);
+
+            g = detail::multiply<P>(g, fg);
+            g.resize(m);
+        }
+
+        g.resize(n);
+        return polynomial(std::move(g));
+    }
+
+    // Formal derivative
+    [[nodiscard]] polynomial derivative () const {
+        std::vector<value_type> ret;
+        for (size_type i=1; i<c.size(); ++i)
+            ret.push_back(c[i] * value_type(i));
+        return polynomial(std::move(ret));
+    }
+
+    // Quotient and remainder of the division by b (b can't be zero)
+    [[nodiscard]] friend std::pair<polynomial, polynomial>
+    divmod (const polynomial &a, const polynomial &b){
+        if (a.c.size() < b.c.size())
+            return {polynomial{}, a};
+
+        const size_type n = a.c.size(), m = b.c.size();
+        const size_type q_size = n - m + 1;
+
+        if (m <= detail::naive_division_threshold || q_size <= detail::naive_division_threshold)
+            return divmod_naive(a, b);
+
+        // rev(q) = rev(a) / rev(b) mod x^{n-m+1}
+        std::vector<value_type> ra(a.c.rbegin(), a.c.rend()), rb(b.c.rbegin(), b.c.rend());
+        ra.resize(q_size);
+        const polynomial rb_inv = polynomial(std::move(rb)).inverse_series(q_size);
+
+        auto q = detail::multiply<P>(ra, rb_inv.c);
+        q.resize(q_size);
+        std::reverse(q.begin(), q.end());
+
+        polynomial quotient(std::move(q));
+        polynomial remainder = a - quotient*b;
+        return {std::move(quotient), std::move(remainder)};
+    }
+
+    // Arithmetic
+    polynomial& operator+= (const polynomial &p){
+        c.resize(std::max(c.size(), p.c.size()));
+        for (size_type i=0; i<p.c.size(); ++i)
+            c[i] += p.c[i];
+        normalize();
+        return *this;
+    }
+    polynomial& operator-= (const polynomial &p){
+        c.resize(std::max(c.size(), p.c.size()));
+        for (size_type i=0; i<p.c.size(); ++i)
+            c[i] -= p.c[i];
+        normalize();
+        return *this;
+    }
+    polynomial& operator*= (const polynomial &p){
+        c = detail::multiply<P>(c, p.c);
+        normalize();
+        return *this;
+    }
+    polynomial& operator*= (const value_type &k){
+        const mul_const<P> kc{k};
+        for (auto &e : c)
+            e *= kc;
+        normalize();
+        return *this;
+    }
+    polynomial& operator/= (const polynomial &p){
+        return *this = divmod(*this, p).first;
+    }
+    polynomial& operator%= (const polynomial &p){
+        return *this = divmod(*this, p).second;
+    }
+
+    friend polynomial operator+ (polynomial lhs, const polynomial &rhs){ return lhs += rhs; }
+    friend polynomial operator- (polynomial lhs, const polynomial &rhs){ return lhs -= rhs; }
+    friend polynomial operator* (polynomial lhs, const polynomial &rhs){ return lhs *= rhs; }
+    friend polynomial operator* (polynomial lhs, const value_type &rhs){ return lhs *= rhs; }
+    friend polynomial operator* (const value_type &lhs, polynomial rhs){ return rhs *= lhs; }
+    friend polynomial operator/ (const polynomial &lhs, const polynomial &rhs){
+        return divmod(lhs, rhs).first;
+    }
+    friend polynomial operator% (const polynomial &lhs, const polynomial &rhs){
+        return divmod(lhs, rhs).second;
+    }
+
+    friend bool operator== (const polynomial &lhs, const polynomial &rhs) noexcept {
+        return lhs.c == rhs.c;
+    }
+    friend bool operator!= (const polynomial &lhs, const polynomial &rhs) noexcept {
+        return !(lhs == rhs);
+    }
+
+private:
+    // Coefficients in increasing degree order, without trailing zeros
+    std::vector<value_type> c;
+
+    void normalize () noexcept {
+        while (!c.empty() && c.back() == 0)
+            c.pop_back();
+    }
+
+    static std::pair<polynomial, polynomial> divmod_naive (const polynomial &a, const polynomial &b){
+        std::vector<value_type> r = a.c;
+        std::vector<value_type> q(a.c.size() - b.c.size() + 1);
+        const value_type lead_inv = value_type(1u) / b.c.back();
+
+        for (size_type i=q.size(); i-- > 0; ){
+            q[i] = r[i + b.c.size() - 1] * lead_inv;
+            const mul_const<P> qi{q[i]};
+            for (size_type j=0; j<b.c.size(); ++j)
+                r[i+j] -= b.c[j] * qi;
+        }
+
+        r.resize(b.c.size() - 1);
+        return {polynomial(std::move(q)), polynomial(std::move(r))};
+    }
+
+    // Products of (x - points[i]) over the segments of a binary tree,
+    // stored in heap order (node 1 is the root)
+    class subproduct_tree{
+    public:
+        explicit subproduct_tree (std::span<const value_type> xs)
+            : points{xs}, nodes(4*xs.size())
+        {
+            build(1, 0, xs.size());
+        }
+
+        [[nodiscard]] const polynomial& root () const noexcept { return nodes[1]; }
+
+        // Remainders down the tree, with Horner at the small leaves
+        void evaluate (const polynomial &r, size_type node, size_type lo, size_type hi,
+                       std::vector<value_type> &out) const
+        {
+            if (hi - lo <= detail::naive_evaluation_threshold){
+                for (size_type i=lo; i<hi; ++i)
+                    out[i] = r(points[i]);
+                return;
+            }
+            const size_type mid = (lo + hi) / 2;
+            evaluate(r % nodes[2*node], 2*node, lo, mid, out);
+            evaluate(r % nodes[2*node+1], 2*node+1, mid, hi, out);
+        }
+
+        // Sum of weights[i] * M(x)/(x - points[i]) over the segment
+        [[nodiscard]] polynomial combine (std::span<const value_type> weights,
+                                          size_type node, size_type lo, size_type hi) const
+        {
+            if (hi - lo == 1)
+                return polynomial{weights[lo]};
+
+            const size_type mid = (lo + hi) / 2;
+            return combine(weights, 2*node, lo, mid) * nodes[2*node+1] +
+                   combine(weights, 2*node+1, mid, hi) * nodes[2*node];
+        }
+
+    private:
+        std::span<const value_type> points;
+        std::vector<polynomial> nodes;
+
+        void build (size_type node, size_type lo, size_type hi){
+            if (hi - lo == 1){
+                nodes[node] = polynomial{-points[lo], value_type(1u)};
+                return;
+            }
+            const size_type mid = (lo + hi) / 2;
+            build(2*node, lo, mid);
+            build(2*node+1, mid, hi);
+            nodes[node] = nodes[2*node] * nodes[2*node+1];
+        }
+    };
+};
+
+}   // namespace fgs
+
+#endif
@@ -0,0 +1,248 @@
+#ifndef Z_MODULE_RANDOM_HPP__
+#define Z_MODULE_RANDOM_HPP__
+
+#include "z_module.hpp"
+
+#include <algorithm>    // std::min
+#include <array>        // std::array
+#include <concepts>     // std::same_as
+#include <cstddef>      // std::size_t
+#include <cstdint>      // std::uint32_t, std::uint64_t
+#include <iostream>     // std::basic_istream, std::basic_ostream, std::ios_base
+#include <limits>       // std::numeric_limits
+#include <random>       // std::uniform_random_bit_generator, std::uniform_int_distribution
+#include <span>         // std::span
+
+namespace fgs{
+
+// Counter-based generator: the i-th output of a stream is a fixed function of
+// (key, i), the SplitMix64 finalizer applied to key + i*gamma. Outputs don't
+// depend on each other, so blocks of them are generated with vectorizable
+// loops and discard() is O(1). Every (seed, stream) pair gives its own
+// sequence, so each thread of a fuzz run can own a stream and still be
+// reproducible
+class counter_engine{
+public:
+    using result_type = std::uint64_t;
+
+    static constexpr result_type default_seed = 0x853C49E6748FEA9Bull;
+
+    constexpr counter_engine () noexcept
+        : counter_engine{default_seed} {}
+
+    explicit constexpr counter_engine (result_type s, result_type stream = 0) noexcept {
+        seed(s, stream);
+    }
+
+    constexpr void seed (result_type s = default_seed, result_type stream = 0) noexcept {
+        key = mix(mix(s) ^ (stream * gamma + gamma));
+        counter = 0;
+    }
+
+    static constexpr result_type min () noexcept { return 0; }
+    static constexpr result_type max () noexcept { return std::numeric_limits<result_type>::max(); }
+
+    constexpr result_type operator() () noexcept {
+        return mix(key + (counter++) * gamma);
+    }
+
+    // Same values as out.size() calls to operator()
+    constexpr void generate (std::span<result_type> out) noexcept {
+        for (std::size_t i=0; i<out.size(); ++i)
+            out[i] = mix(key + (counter + i) * gamma);
+        counter += out.size();
+    }
+
+    constexpr void discard (unsigned long long z) noexcept {
+        counter += z;
+    }
+
+    friend constexpr bool operator== (const counter_engine&, const counter_engine&) noexcept = default;
+
+    template <typename CharT, typename Traits>
+    friend std::basic_ostream<CharT, Traits>&
+    operator<< (std::basic_ostream<CharT, Traits> &os, const counter_engine &e){
+        return os << e.key << os.widen(' ') << e.counter;
+    }
+
+    template <typename CharT, typename Traits>
+    friend std::basic_istream<CharT, Traits>&
+    operator>> (std::basic_istream<CharT, Traits> &is, counter_engine &e){
+        return is >> e.key >> e.counter;
+    }
+
+private:
+    static constexpr result_type gamma = 0x9E3779B97F4A7C15ull;
+
+    result_type key{};
+    result_type counter{};
+
+    static constexpr result_type mix (result_type z) noexcept {
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+};
+
+// Uniform distribution over Z<Integer>. It follows the <random> distribution
+// interface (param_type, reset, operator()(g), min/max), although it isn't a
+// RandomNumberDistribution, since z-modules aren't arithmetic types.
+//
+// Samples use Lemire's nearly divisionless method: with a random word x of
+// W bits, the high half of x*N is uniform in [0, N) once the draws whose low
+// half is below 2^W mod N are rejected. N is known at compile time, so that
+// threshold is a constant and no division is ever done (powers of two don't
+// even reject). Engines whose outputs aren't whole 32 or 64 bits words go
+// through std::uniform_int_distribution
+template <std::integral auto Integer> requires (Integer > 1)
+class uniform_zmodule_distribution{
+public:
+    using result_type = ZModule<Integer>;
+
+    // There's nothing to parametrize, the range is the whole ring
+    struct param_type{
+        using distribution_type = uniform_zmodule_distribution;
+        friend constexpr bool operator== (const param_type&, const param_type&) noexcept = default;
+    };
+
+    constexpr uniform_zmodule_distribution () noexcept = default;
+    explicit constexpr uniform_zmodule_distribution (const param_type&) noexcept {}
+
+    constexpr void reset () noexcept {}
+
+    [[nodiscard]] constexpr param_type param () const noexcept { return {}; }
+    constexpr void param (const param_type&) noexcept {}
+
+    [[nodiscard]] static constexpr result_type min () noexcept { return result_type(0u); }
+    [[nodiscard]] static constexpr result_type max () noexcept { return assume_reduced<Integer>(N-1); }
+
+    template <std::uniform_random_bit_generator G>
+    result_type operator() (G &g){
+        if constexpr (full_word<G, std::uint64_t> || (full_word<G, std::uint32_t> && N > max32)){
+            // Words of 64 bits, pairing outputs if the engine only gives 32
+            for (;;){
+                const auto m = static_cast<detail::uint128_t>(draw64(g)) * N;
+                if (static_cast<std::uint64_t>(m) >= threshold<std::uint64_t>)
+                    return assume_reduced<Integer>(static_cast<value_type>(m >> 64));
+            }
+        }
+        else if constexpr (full_word<G, std::uint32_t>){
+            for (;;){
+                const std::uint64_t m = static_cast<std::uint64_t>(static_cast<std::uint32_t>(g() - G::min())) * N;
+                if (static_cast<std::uint32_t>(m) >= threshold<std::uint32_t>)
+                    return assume_reduced<Integer>(static_cast<value_type>(m >> 32));
+            }
+        }
+        else{
+            return assume_reduced<Integer>(static_cast<value_type>(
+                std::uniform_int_distribution<std::uint64_t>(0, N-1)(g)
+            ));
+        }
+    }
+
+    template <std::uniform_random_bit_generator G>
+    result_type operator() (G &g, const param_type&){
+        return (*this)(g);
+    }
+
+    // Fills out with samples, the same ones as out.size() calls to operator()
+    template <std::uniform_random_bit_generator G>
+    void generate (std::span<result_type> out, G &g){
+        for (auto &e : out)
+            e = (*this)(g);
+    }
+
+    // Counter-based engines produce blocks of words at once, which are then
+    // turned into samples in order. Rejected words are skipped, so the
+    // samples are still the same ones operator() would give
+    void generate (std::span<result_type> out, counter_engine &g) noexcept {
+        std::array<std::uint64_t, block> words;
+
+        for (std::size_t i=0; i<out.size(); ){
+            const std::size_t n = std::min(block, out.size() - i);
+            g.generate(std::span(words).first(n));
+
+            if constexpr (threshold<std::uint64_t> == 0){
+                for (std::size_t j=0; j<n; ++j)
+                    out[i+j] = assume_reduced<Integer>(static_cast<value_type>(
+                        (static_cast<detail::uint128_t>(words[j]) * N) >> 64
+                    ));
+                i += n;
+            }
+            else{
+                // Rejections are rare, so the whole block is converted without
+                // branches, and only redone word by word if any of them failed
+                bool rejected = false;
+                for (std::size_t j=0; j<n; ++j){
+                    const auto m = static_cast<detail::uint128_t>(words[j]) * N;
+                    rejected |= (static_cast<std::uint64_t>(m) < threshold<std::uint64_t>);
+                    out[i+j] = assume_reduced<Integer>(static_cast<value_type>(m >> 64));
+                }
+
+                if (!rejected){
+                    i += n;
+                    continue;
+                }
+                for (std::size_t j=0; j<n; ++j){
+                    const auto m = static_cast<detail::uint128_t>(words[j]) * N;
+                    if (static_cast<std::uint64_t>(m) >= threshold<std::uint64_t>)
+                        out[i++] = assume_reduced<Integer>(static_cast<value_type>(m >> 64));
+                }
+            }
+        }
+    }
+
+    friend constexpr bool operator== (const uniform_zmodule_distribution&,
+                                      const uniform_zmodule_distribution&) noexcept = default;
+
+    // The only state is the modulus, which has to match when reading
+    template <typename CharT, typename Traits>
+    friend std::basic_ostream<CharT, Traits>&
+    operator<< (std::basic_ostream<CharT, Traits> &os, const uniform_zmodule_distribution&){
+        return os << N;
+    }
+
+    template <typename CharT, typename Traits>
+    friend std::basic_istream<CharT, Traits>&
+    operator>> (std::basic_istream<CharT, Traits> &is, uniform_zmodule_distribution&){
+        value_type n{};
+        if (is >> n && n != N)
+            is.setstate(std::ios_base::failbit);
+        return is;
+    }
+
+private:
+    using value_type = typename result_type::value_type;
+    static constexpr value_type N = result_type::N;
+    static constexpr std::uint64_t max32 = std::numeric_limits<std::uint32_t>::max();
+
+    // Words turned into samples at once by the bulk path
+    static constexpr std::size_t block = 64;
+
+    // 2^W mod N, the rejection threshold for words of type W
+    template <typename W>
+    static constexpr W threshold = (N > std::numeric_limits<W>::max())
+        ? W(0)  // Never used
+        : static_cast<W>(static_cast<W>(W(0) - static_cast<W>(N)) % static_cast<W>(N));
+
+    // Whether G produces uniform words of exactly the bits of W
+    template <typename G, typename W>
+    static constexpr bool full_word =
+        static_cast<detail::uint128_t>(G::max() - G::min()) == std::numeric_limits<W>::max();
+
+    template <typename G>
+    static std::uint64_t draw64 (G &g){
+        if constexpr (full_word<G, std::uint64_t>){
+            return static_cast<std::uint64_t>(g() - G::min());
+        }
+        else{
+            const auto hi = static_cast<std::uint64_t>(static_cast<std::uint32_t>(g() - G::min()));
+            const auto lo = static_cast<std::uint64_t>(static_cast<std::uint32_t>(g() - G::min()));
+            return (hi << 32) | lo;
+        }
+    }
+};
+
+}   // namespace fgs
+
+#endif
@@ -0,0 +1,187 @@
+#ifndef Z_MODULE_ROLLING_HASH_HPP__
+#define Z_MODULE_ROLLING_HASH_HPP__
+
+#include "z_module.hpp"
+
+#include <cstddef>      // std::size_t
+#include <iterator>     // std::ranges::begin, std::ranges::end
+#include <ranges>       // std::ranges::input_range, std::ranges::range_value_t, std::ranges::size
+#include <tuple>        // std::tuple, std::apply
+#include <vector>       // std::vector
+
+namespace fgs{
+
+template <typename... Hashes>
+requires (sizeof...(Hashes) > 0)
+class multi_rolling_hash;
+
+// Polynomial (Rabin-Karp) hash over the ring Z<Integer>. The hash of a
+// sequence s_0, ..., s_{n-1} is s_0*Base^{n-1} + ... + s_{n-2}*Base + s_{n-1}.
+//
+// Prefix hashes and base powers are precomputed at construction, so the hash
+// of any subsequence can be retrieved in O(1)
+template <std::integral auto Integer, std::integral auto Base>
+requires (Integer > 1)
+class rolling_hash{
+public:
+    using value_type = ZModule<Integer>;
+    using size_type  = std::size_t;
+
+    rolling_hash () = default;
+
+    // Builds the prefix hashes of any range of integral values (strings included)
+    template <std::ranges::input_range R>
+    requires std::integral<std::ranges::range_value_t<R>>
+    explicit rolling_hash (const R &r){
+        start(r);
+        for (auto&& e : r)
+            push<std::ranges::range_value_t<R>>(e);
+        finish();
+    }
+
+    // Number of elements hashed
+    [[nodiscard]] constexpr size_type size () const noexcept {
+        return powers.empty() ? 0 : powers.size() - 1;
+    }
+
+    // Hash of the whole input
+    [[nodiscard]] value_type hash () const noexcept {
+        return prefix.empty() ? value_type(0u) : prefix.back();
+    }
+
+    // Hash of the subsequence [pos, pos+count). Out of range is undefined behaviour
+    [[nodiscard]] value_type operator() (size_type pos, size_type count) const noexcept {
+        return prefix[pos+count] - prefix[pos]*powers[count];
+    }
+
+    // Base^k, for 0 <= k <= size()
+    [[nodiscard]] value_type power (size_type k) const noexcept {
+        return powers[k];
+    }
+
+    // Hash of a range without storing anything (useful for patterns)
+    template <std::ranges::input_range R>
+    requires std::integral<std::ranges::range_value_t<R>>
+    [[nodiscard]] static constexpr value_type hash_of (const R &r) noexcept {
+        value_type h(0u);
+        for (auto&& e : r)
+            h = step<std::ranges::range_value_t<R>>(h, e);
+        return h;
+    }
+
+private:
+    // multi_rolling_hash feeds its hashes with start, push and finish, so
+    // they all share a single pass over the input
+    template <typename... Hashes>
+    requires (sizeof...(Hashes) > 0)
+    friend class multi_rolling_hash;
+
+    static constexpr value_type BASE{Base};
+    // The base with its Shoup constant, for the loops over the whole input
+    static constexpr mul_const<Integer> BASE_PRECOMPUTED{BASE};
+
+    std::vector<value_type> prefix;
+    std::vector<value_type> powers;
+
+    // Characters are taken by their unsigned value, so 'char' behaves
+    // the same no matter its signedness, and bools as 0 and 1. T is given
+    // explicitly, so proxy references (std::vector<bool>) are converted to it
+    template <std::integral T>
+    static constexpr value_type to_element (const T &e) noexcept {
+        return value_type(static_cast<detail::magnitude_t<T>>(e));
+    }
+
+    // Hash of the sequence h stands for, followed by e
+    template <std::integral T>
+    static constexpr value_type step (const value_type &h, const T &e) noexcept {
+        return h*BASE_PRECOMPUTED + to_element<T>(e);
+    }
+
+    template <std::ranges::input_range R>
+    void start (const R &r){
+        if constexpr (std::ranges::sized_range<R>)
+            prefix.reserve(static_cast<size_type>(std::ranges::size(r)) + 1);
+        prefix.push_back(value_type(0u));
+    }
+
+    // prefix[i+1] is the hash of [0, i]
+    template <std::integral T>
+    void push (const T &e){
+        prefix.push_back(step<T>(prefix.back(), e));
+    }
+
+    void finish (){
+        const size_type n = prefix.size() - 1;
+        powers.resize(n+1);
+        powers[0] = value_type(1u);
+        for (size_type i=1; i<=n; ++i)
+            powers[i] = powers[i-1]*BASE_PRECOMPUTED;
+    }
+};
+
+// Several rolling hashes over the same input (usually with different
+// moduli) to reduce the probability of collisions. Substring hashes are
+// returned as tuples, which can be compared directly.
+//
+// The input is traversed only once, every element feeding all the hashes,
+// so their multiplication chains also overlap
+template <typename... Hashes>
+requires (sizeof...(Hashes) > 0)
+class multi_rolling_hash{
+public:
+    using value_type = std::tuple<typename Hashes::value_type...>;
+    using size_type  = std::size_t;
+
+    multi_rolling_hash () = default;
+
+    template <std::ranges::input_range R>
+    requires std::integral<std::ranges::range_value_t<R>>
+    explicit multi_rolling_hash (const R &r){
+        using T = std::ranges::range_value_t<R>;
+        std::apply([&](auto&... h){ (h.start(r), ...); }, hashes);
+        for (auto&& e : r){
+            const T x = e;
+            std::apply([x](auto&... h){ (h.template push<T>(x), ...); }, hashes);
+        }
+        std::apply([](auto&... h){ (h.finish(), ...); }, hashes);
+    }
+
+    [[nodiscard]] constexpr size_type size () const noexcept {
+        return std::get<0>(hashes).size();
+    }
+
+    [[nodiscard]] value_type hash () const noexcept {
+        return std::apply([](const auto&... h){ return value_type{h.hash()...}; }, hashes);
+    }
+
+    [[nodiscard]] value_type operator() (size_type pos, size_type count) const noexcept {
+        return std::apply([=](const auto&... h){ return value_type{h(pos, count)...}; }, hashes);
+    }
+
+    template <std::ranges::input_range R>
+    requires std::integral<std::ranges::range_value_t<R>>
+    [[nodiscard]] static constexpr value_type hash_of (const R &r) noexcept {
+        using T = std::ranges::range_value_t<R>;
+        value_type ret{typename Hashes::value_type(0u)...};
+        for (auto&& e : r){
+            const T x = e;
+            ret = std::apply([x](const auto&... h){
+                return value_type{Hashes::template step<T>(h, x)...};
+            }, ret);
+        }
+        return ret;
+    }
+
+private:
+    std::tuple<Hashes...> hashes;
+};
+
+// The usual double hashing
+template <std::integral auto Integer1, std::integral auto Base1,
+          std::integral auto Integer2, std::integral auto Base2>
+using double_rolling_hash = multi_rolling_hash<rolling_hash<Integer1, Base1>,
+                                               rolling_hash<Integer2, Base2>>;
+
+}   // namespace fgs
+
+#endif
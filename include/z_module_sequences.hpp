@@ -0,0 +1,450 @@
+#ifndef Z_MODULE_SEQUENCES_HPP__
+#define Z_MODULE_SEQUENCES_HPP__
+
+#include "z_module.hpp"
+#include "z_module_polynomial.hpp"
+
+#include <algorithm>    // std::copy, std::min, std::reverse
+#include <array>        // std::array
+#include <bit>          // std::bit_width
+#include <cstddef>      // std::size_t, std::ptrdiff_t
+#include <cstdint>      // std::uint64_t
+#include <iterator>     // std::forward_iterator_tag, std::input_iterator_tag, std::unreachable_sentinel_t
+#include <ranges>       // std::ranges::view_interface
+#include <span>         // std::span, std::dynamic_extent
+#include <type_traits>  // std::conditional_t
+#include <utility>      // std::move
+#include <vector>       // std::vector
+
+namespace fgs{
+
+namespace detail{
+    // Sequences of a compile-time order keep their state in arrays, so they
+    // never allocate; the rest use vectors
+    template <typename T, std::size_t Order, std::size_t Factor = 1>
+    using sequence_storage = std::conditional_t<Order == std::dynamic_extent,
+                                                std::vector<T>,
+                                                std::array<T, Order*Factor>>;
+
+    // Iterator over an infinite sequence. It owns a copy of the generator,
+    // so iterating never advances the sequence it came from
+    template <typename Sequence>
+    class sequence_iterator{
+    public:
+        using value_type        = typename Sequence::value_type;
+        using difference_type   = std::ptrdiff_t;
+        using iterator_concept  = std::forward_iterator_tag;
+        using iterator_category = std::input_iterator_tag;  // Terms are returned by value
+
+        sequence_iterator () = default;
+        explicit sequence_iterator (const Sequence &s)
+            : seq{s} {}
+
+        value_type operator* () const noexcept {
+            return seq.peek();
+        }
+
+        sequence_iterator& operator++ () noexcept {
+            seq.next(); ++pos;
+            return *this;
+        }
+        sequence_iterator operator++ (int) {
+            sequence_iterator ret{*this};
+            ++(*this);
+            return ret;
+        }
+
+        // Only meaningful for iterators over the same sequence
+        friend bool operator== (const sequence_iterator &lhs, const sequence_iterator &rhs) noexcept {
+            return lhs.pos == rhs.pos;
+        }
+
+    private:
+        Sequence seq{};
+        std::size_t pos = 0;
+    };
+
+    /* Arithmetic modulo a monic polynomial f of degree k, for the jumps of
+     * the linear recurrences (Fiduccia's algorithm): if f is the characteristic
+     * polynomial, a_n is the dot product of x^n mod f with a_0, ..., a_{k-1}.
+     *
+     * Products are reduced with the schoolbook division for small k, and with
+     * a precomputed inverse of rev(f) otherwise (one product per reduction
+     * instead of a full divmod), so x^n mod f costs O(M(k) log n)
+     */
+    template <auto P>
+    class monic_modulus{
+    public:
+        using value_type = ZModule<P>;
+        using size_type  = std::size_t;
+
+        // Coefficients of f in increasing degree order, with f[k] = 1
+        explicit monic_modulus (std::vector<value_type> coeffs)
+            : f{std::move(coeffs)}, k{f.size()-1}
+        {
+            if (k > naive_division_threshold){
+                std::vector<value_type> rf(f.rbegin(), f.rend());
+                rev_inverse = polynomial<P>(std::move(rf)).inverse_series(k).coefficients();
+                rev_inverse.resize(k);
+            }
+        }
+
+        // a*b mod f, with a and b of size k
+        [[nodiscard]] std::vector<value_type> multiply (std::span<const value_type> a,
+                                                        std::span<const value_type> b) const
+        {
+            auto g = detail::multiply<P>(a, b);
+            reduce(g);
+            return g;
+        }
+
+        // a*x mod f, in place
+        void shift (std::vector<value_type> &a) const noexcept {
+            const mul_const<P> top{a[k-1]};
+            for (size_type i=k-1; i>0; --i)
+                a[i] = a[i-1] - f[i]*top;
+            a[0] = -(f[0]*top);
+        }
+
+        // x^n mod f
+        [[nodiscard]] std::vector<value_type> power_of_x (std::uint64_t n) const {
+            std::vector<value_type> r(k);
+            r[0] = value_type(1u);
+            for (int bit=std::bit_width(n)-1; bit>=0; --bit){
+                r = multiply(r, r);
+                if ((n >> bit) & 1u)
+                    shift(r);
+            }
+            return r;
+        }
+
+    private:
+        std::vector<value_type> f;
+        size_type k;
+        std::vector<value_type> rev_inverse;   // rev(f)^{-1} mod x^k
+
+        // g mod f, for g of size at most 2k-1. Leaves exactly k coefficients
+        void reduce (std::vector<value_type> &g) const {
+            if (g.size() > k){
+                if (k <= naive_division_threshold){
+                    for (size_type i=g.size()-1; i>=k; --i){
+                        const mul_const<P> t{g[i]};
+                        for (size_type j=0; j<k; ++j)
+                            g[i-k+j] -= f[j]*t;
+                    }
+                }
+                else{
+                    // rev(q) = rev(g) * rev(f)^{-1} mod x^{size-k}
+                    const size_type q_size = g.size() - k;
+                    std::vector<value_type> rg(g.rbegin(), g.rbegin() + static_cast<std::ptrdiff_t>(q_size));
+                    auto q = detail::multiply<P>(rg, std::span<const value_type>(rev_inverse).first(q_size));
+                    q.resize(q_size);
+                    std::reverse(q.begin(), q.end());
+
+                    // Only the low k coefficients of q*f are needed, and x^k
+                    // (the leading term) doesn't reach them
+                    const auto qf = detail::multiply<P>(q, std::span<const value_type>(f).first(k));
+                    for (size_type i=0; i<k; ++i)
+                        g[i] -= qf[i];
+                }
+            }
+            g.resize(k);
+        }
+    };
+}   // namespace detail
+
+// Geometric progression first, first*ratio, first*ratio^2, ... as an infinite
+// range. It's also a generator: next() and next_n() consume terms, while
+// iterating over it or calling nth() leaves it untouched
+template <std::integral auto Integer> requires (Integer > 1)
+class geometric_sequence : public std::ranges::view_interface<geometric_sequence<Integer>>{
+public:
+    using value_type = ZModule<Integer>;
+    using size_type  = std::size_t;
+    using iterator   = detail::sequence_iterator<geometric_sequence>;
+
+    // Number of independent chains used by next_n
+    static constexpr size_type LANES = 8;
+
+    constexpr geometric_sequence () noexcept = default;
+
+    constexpr geometric_sequence (const value_type &first, const value_type &ratio) noexcept
+        : start{first}, current{first}, step{ratio}, lanes_step{ratio ^ LANES} {}
+
+    iterator begin () const { return iterator{*this}; }
+    static constexpr std::unreachable_sentinel_t end () noexcept { return {}; }
+
+    // Next term, without consuming it
+    [[nodiscard]] constexpr value_type peek () const noexcept {
+        return current;
+    }
+
+    constexpr value_type next () noexcept {
+        const value_type ret = current;
+        current *= step;
+        ++index;
+        return ret;
+    }
+
+    // Fills out with the next terms. After the first LANES of them, term i
+    // is term i-LANES times ratio^LANES, so there are LANES independent
+    // multiplication chains instead of a single one
+    constexpr void next_n (std::span<value_type> out) noexcept {
+        const size_type head = std::min(out.size(), LANES);
+        for (size_type i=0; i<head; ++i)
+            out[i] = next();
+
+        if (out.size() > LANES){
+            for (size_type i=LANES; i<out.size(); ++i)
+                out[i] = out[i-LANES] * lanes_step;
+            current = out.back() * step;
+            index += out.size() - LANES;
+        }
+    }
+
+    // Term of index n, counting from the first one, in O(log n)
+    [[nodiscard]] constexpr value_type nth (std::uint64_t n) const noexcept {
+        return start * (step.value() ^ n);
+    }
+
+    // Moves the generator to the term of index n
+    constexpr void seek (std::uint64_t n) noexcept {
+        current = nth(n);
+        index = n;
+    }
+
+    // Index of the next term to be generated
+    [[nodiscard]] constexpr std::uint64_t position () const noexcept {
+        return index;
+    }
+
+private:
+    value_type start{};
+    value_type current{};
+    mul_const<Integer> step{};
+    mul_const<Integer> lanes_step{};
+    std::uint64_t index = 0;
+};
+
+// 1, g, g^2, ...
+template <auto Integer>
+[[nodiscard]] constexpr geometric_sequence<Integer> powers (const ZModule<Integer> &g) noexcept {
+    return geometric_sequence<Integer>(ZModule<Integer>(1u), g);
+}
+
+// Linear recurrence a_n = c_0*a_{n-1} + c_1*a_{n-2} + ... + c_{k-1}*a_{n-k},
+// starting from a_0, ..., a_{k-1}, as an infinite range and a generator (same
+// interface as geometric_sequence). With an order known at compile time the
+// state lives in arrays, so it doesn't allocate, iterators included.
+//
+// nth() and seek() jump with Fiduccia's algorithm: O(k^2 log n) for small
+// orders, and subquadratic polynomial products (NTT when available) otherwise
+template <std::integral auto Integer, std::size_t Order = std::dynamic_extent>
+requires (Integer > 1 && Order > 0)
+class linear_recurrence : public std::ranges::view_interface<linear_recurrence<Integer, Order>>{
+public:
+    using value_type = ZModule<Integer>;
+    using size_type  = std::size_t;
+    using iterator   = detail::sequence_iterator<linear_recurrence>;
+
+    linear_recurrence () = default;
+
+    // Both spans must have the same non zero size, the order of the recurrence
+    constexpr linear_recurrence (std::span<const value_type, Order> coeffs,
+                                 std::span<const value_type, Order> init)
+    {
+        const size_type k = init.size();
+        if constexpr (Order == std::dynamic_extent){
+            c.resize(k);
+            start.resize(k);
+            window.resize(2*k);
+        }
+
+        for (size_type i=0; i<k; ++i){
+            c[i] = mul_const<Integer>{coeffs[i]};
+            start[i] = window[i] = window[i+k] = init[i];
+        }
+    }
+
+    [[nodiscard]] constexpr size_type order () const noexcept {
+        return start.size();
+    }
+
+    iterator begin () const { return iterator{*this}; }
+    static constexpr std::unreachable_sentinel_t end () noexcept { return {}; }
+
+    // Next term, without consuming it
+    [[nodiscard]] constexpr value_type peek () const noexcept {
+        return window[pos];
+    }
+
+    // The k upcoming terms are stored twice in window (at pos+i and pos+i+k),
+    // so they can be read as a contiguous block whatever pos is
+    constexpr value_type next () noexcept {
+        const size_type k = order();
+        const value_type ret = window[pos];
+
+        value_type t(0u);
+        for (size_type i=0; i<k; ++i)
+            t += window[pos+k-1-i] * c[i];
+
+        window[pos] = window[pos+k] = t;
+        pos = (pos+1 == k) ? 0 : pos+1;
+        ++index;
+        return ret;
+    }
+
+    // Fills out with the next terms. Past the k of them already in the
+    // window, each term is computed right in out from the k before it, with
+    // the products accumulated lazily and a single reduction per term
+    // (next() pays one per product), and the window is only rebuilt at the end
+    constexpr void next_n (std::span<value_type> out) noexcept {
+        const size_type k = order(), n = out.size();
+        if (n <= k){
+            for (auto &e : out)
+                e = next();
+            return;
+        }
+
+        for (size_type i=0; i<k; ++i)
+            out[i] = window[pos+i];
+        for (size_type i=k; i<n; ++i)
+            out[i] = combine(out.subspan(i-k, k));
+
+        // The last k terms, followed by the k upcoming ones
+        for (size_type i=0; i<k; ++i)
+            window[i] = out[n-k+i];
+        for (size_type i=0; i<k; ++i)
+            window[i+k] = combine(std::span<const value_type>(window).subspan(i, k));
+        for (size_type i=0; i<k; ++i)
+            window[i] = window[i+k];
+        pos = 0;
+        index += n;
+    }
+
+    // Term of index n, counting from a_0
+    [[nodiscard]] value_type nth (std::uint64_t n) const {
+        if (n < order())
+            return start[static_cast<size_type>(n)];
+        return dot(characteristic().power_of_x(n));
+    }
+
+    // Moves the generator to the term of index n. The k terms in the window
+    // come from x^n, ..., x^{n+k-1} mod f, each one a shift of the previous
+    void seek (std::uint64_t n){
+        const size_type k = order();
+        const auto f = characteristic();
+
+        auto r = f.power_of_x(n);
+        for (size_type i=0; i<k; ++i){
+            window[i] = window[i+k] = dot(r);
+            f.shift(r);
+        }
+        pos = 0;
+        index = n;
+    }
+
+    // Index of the next term to be generated
+    [[nodiscard]] constexpr std::uint64_t position () const noexcept {
+        return index;
+    }
+
+private:
+    detail::sequence_storage<mul_const<Integer>, Order> c{};
+    detail::sequence_storage<value_type, Order> start{};
+    detail::sequence_storage<value_type, Order, 2> window{};
+    size_type pos = 0;
+    std::uint64_t index = 0;
+
+    // x^k - c_0*x^{k-1} - ... - c_{k-1}
+    [[nodiscard]] detail::monic_modulus<Integer> characteristic () const {
+        const size_type k = order();
+        std::vector<value_type> f(k+1);
+        for (size_type i=0; i<k; ++i)
+            f[k-1-i] = -c[i].value();
+        f[k] = value_type(1u);
+        return detail::monic_modulus<Integer>(std::move(f));
+    }
+
+    // c_0*prev[k-1] + ... + c_{k-1}*prev[0], the term after the k in prev
+    [[nodiscard]] constexpr value_type combine (std::span<const value_type> prev) const noexcept {
+        using detail::zmodule_access;
+        using wide_type = typename detail::lazy_accumulator<value_type::N>::type;
+
+        const size_type k = prev.size();
+        return assume_reduced<Integer>(detail::lazy_sum<value_type::N>(k, [&](size_type i){
+            return static_cast<wide_type>(zmodule_access::residue(c[i].value())) *
+                   zmodule_access::residue(prev[k-1-i]);
+        }));
+    }
+
+    // Term whose expression in terms of the initial values is r
+    [[nodiscard]] value_type dot (const std::vector<value_type> &r) const noexcept {
+        value_type ret(0u);
+        for (size_type i=0; i<r.size(); ++i)
+            ret += r[i] * start[i];
+        return ret;
+    }
+};
+
+template <auto Integer, std::size_t K>
+linear_recurrence (const std::array<ZModule<Integer>, K>&, const std::array<ZModule<Integer>, K>&)
+    -> linear_recurrence<Integer, K>;
+
+template <auto Integer>
+linear_recurrence (const std::vector<ZModule<Integer>>&, const std::vector<ZModule<Integer>>&)
+    -> linear_recurrence<Integer>;
+
+// Shortest linear recurrence generating s (Berlekamp-Massey), as coefficients
+// c with s_n = c_0*s_{n-1} + ... + c_{k-1}*s_{n-k}, the convention of
+// linear_recurrence. 2k terms of a sequence of order k are enough to find it.
+// Needs P to be prime, and takes O(n^2) with lazily reduced discrepancies
+template <std::integral auto P> requires (P > 1)
+[[nodiscard]] std::vector<ZModule<P>> berlekamp_massey (std::span<const ZModule<P>> s){
+    using value_type = ZModule<P>;
+    using detail::zmodule_access;
+    using wide_type = typename detail::lazy_accumulator<value_type::N>::type;
+
+    // Connection polynomials: C(x) = 1 - c_0*x - ... - c_{L-1}*x^L for the
+    // current recurrence, and B(x) the one before the last length change,
+    // whose discrepancy was b. C is corrected with multiples of x^shift*B(x)
+    std::vector<value_type> C{value_type(1u)}, B{value_type(1u)}, T;
+    value_type b(1u);
+    std::size_t L = 0, shift = 1;
+
+    for (std::size_t i=0; i<s.size(); ++i, ++shift){
+        const std::size_t terms = std::min(C.size(), i+1);
+        const value_type d = assume_reduced<P>(detail::lazy_sum<value_type::N>(terms, [&](std::size_t j){
+            return static_cast<wide_type>(zmodule_access::residue(C[j])) * zmodule_access::residue(s[i-j]);
+        }));
+        if (d == 0u)
+            continue;
+
+        const bool grows = (2*L <= i);
+        if (grows)
+            T = C;
+
+        const mul_const<P> coef{d / b};
+        if (C.size() < B.size() + shift)
+            C.resize(B.size() + shift);
+        for (std::size_t j=0; j<B.size(); ++j)
+            C[j+shift] -= B[j] * coef;
+
+        if (grows){
+            L = i+1 - L;
+            B = std::move(T);
+            b = d;
+            shift = 0;
+        }
+    }
+
+    C.resize(L+1);
+    std::vector<value_type> ret(L);
+    for (std::size_t j=0; j<L; ++j)
+        ret[j] = -C[j+1];
+    return ret;
+}
+
+}   // namespace fgs
+
+#endif
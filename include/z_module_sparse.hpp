@@ -0,0 +1,298 @@
+#ifndef Z_MODULE_SPARSE_HPP__
+#define Z_MODULE_SPARSE_HPP__
+
+#include "z_module.hpp"
+#include "z_module_polynomial.hpp"
+#include "z_module_random.hpp"
+#include "z_module_sequences.hpp"
+#include "detail/parallel.hpp"
+
+#include <algorithm>    // std::lower_bound, std::max, std::sort
+#include <array>        // std::array
+#include <cstddef>      // std::size_t
+#include <cstdint>      // std::uint32_t, std::uint64_t
+#include <limits>       // std::numeric_limits
+#include <span>         // std::span
+#include <utility>      // std::move, std::pair
+#include <vector>       // std::vector
+
+#ifdef FGS_EXCEPTIONS_SUPPORT
+    #include <stdexcept>    // std::out_of_range
+    #include <string>       // std::to_string
+#endif
+
+namespace fgs{
+
+// Storage of the entries of a sparse_zmatrix
+enum class sparse_layout{
+    csr,    // Compressed rows: rows of any length, stored back to back
+    ell     // ELLPACK: every row padded to the length of the longest one, so
+            // all of them run the same loop. Best for near-regular matrices
+};
+
+// Sparse matrix over Z<Integer>, for the matrix-vector products of iterative
+// methods (Wiedemann, Lanczos...).
+//
+// Each row of a product is accumulated in a wide integer and only reduced
+// when more products could overflow it (see detail::lazy_accumulator), so
+// most rows pay a single reduction. Rows are split among threads in blocks
+// with about the same number of entries, and products by K vectors at once
+// read the matrix a single time for all of them. Column indices take 32 bits,
+// so there can't be more than 2^32 columns
+template <std::integral auto Integer> requires (Integer > 1)
+class sparse_zmatrix{
+public:
+    using value_type = ZModule<Integer>;
+    using size_type  = std::size_t;
+    using index_type = std::uint32_t;
+
+    // Coordinate form of an entry
+    struct entry{
+        size_type row;
+        size_type col;
+        value_type value;
+
+        friend constexpr bool operator== (const entry&, const entry&) noexcept = default;
+    };
+
+    sparse_zmatrix () = default;
+
+    // Entries may come in any order. Repeated positions are added up, and
+    // zeros are dropped. Positions must lie inside the matrix: out of range
+    // ones throw with exceptions support, and are undefined behaviour otherwise
+    sparse_zmatrix (size_type rows, size_type cols, std::span<const entry> entries,
+                    sparse_layout layout = sparse_layout::csr)
+        : n_rows{rows}, n_cols{cols}, storage{layout}
+    {
+#ifdef FGS_EXCEPTIONS_SUPPORT
+        for (const auto &e : entries)
+            if (e.row >= rows || e.col >= cols)
+                throw std::out_of_range("Entry (" + std::to_string(e.row) + ", " + std::to_string(e.col) +
+                                        ") out of a " + std::to_string(rows) + "x" + std::to_string(cols) + " matrix");
+#endif
+
+        // Bucket the entries by row, then sort and merge every row
+        std::vector<size_type> start(rows+1, 0);
+        for (const auto &e : entries)
+            ++start[e.row+1];
+        for (size_type r=0; r<rows; ++r)
+            start[r+1] += start[r];
+
+        std::vector<std::pair<index_type, value_type>> bucket(entries.size());
+        {
+            std::vector<size_type> next(start.begin(), start.end()-1);
+            for (const auto &e : entries)
+                bucket[next[e.row]++] = {static_cast<index_type>(e.col), e.value};
+        }
+
+        row_start.assign(rows+1, 0);
+        for (size_type r=0; r<rows; ++r){
+            const auto first = bucket.begin() + static_cast<std::ptrdiff_t>(start[r]);
+            const auto last  = bucket.begin() + static_cast<std::ptrdiff_t>(start[r+1]);
+            std::sort(first, last, [](const auto &a, const auto &b){ return a.first < b.first; });
+
+            for (auto it=first; it!=last; ){
+                const index_type c = it->first;
+                value_type v(0u);
+                for (; it!=last && it->first == c; ++it)
+                    v += it->second;
+                if (v != 0u){
+                    col.push_back(c);
+                    val.push_back(v);
+                }
+            }
+            row_start[r+1] = col.size();
+            width = std::max(width, row_start[r+1] - row_start[r]);
+        }
+        nnz = col.size();
+
+        if (storage == sparse_layout::ell)
+            to_ell();
+    }
+
+    [[nodiscard]] size_type rows () const noexcept { return n_rows; }
+    [[nodiscard]] size_type cols () const noexcept { return n_cols; }
+    [[nodiscard]] size_type nonzeros () const noexcept { return nnz; }
+    [[nodiscard]] sparse_layout layout () const noexcept { return storage; }
+
+    // Nonzero entries, sorted by row and column
+    [[nodiscard]] std::vector<entry> entries () const {
+        std::vector<entry> ret;
+        ret.reserve(nnz);
+        for (size_type r=0; r<n_rows; ++r){
+            const auto [first, length] = row_range(r);
+            for (size_type j=first; j<first+length; ++j)
+                if (val[j] != 0u)   // ELL padding
+                    ret.push_back({r, col[j], val[j]});
+        }
+        return ret;
+    }
+
+    [[nodiscard]] sparse_zmatrix transpose () const {
+        auto e = entries();
+        for (auto &x : e)
+            std::swap(x.row, x.col);
+        return sparse_zmatrix(n_cols, n_rows, e, storage);
+    }
+
+    // y = A*x. x needs cols() elements and y rows() elements
+    void multiply (std::span<const value_type> x, std::span<value_type> y) const {
+        using detail::zmodule_access;
+        using wide_type = typename detail::lazy_accumulator<N>::type;
+
+        for_row_blocks([&](size_type lo, size_type hi){
+            for (size_type r=lo; r<hi; ++r){
+                const auto [first, length] = row_range(r);
+                const index_type *c = col.data() + first;
+                const value_type *a = val.data() + first;
+
+                y[r] = assume_reduced<Integer>(detail::lazy_sum<N>(length, [&](size_type j){
+                    return static_cast<wide_type>(zmodule_access::residue(a[j])) * zmodule_access::residue(x[c[j]]);
+                }));
+            }
+        });
+    }
+
+    // Y = A*X for K vectors at once, stored interleaved: x[j][k] is element j
+    // of the k-th vector. Every entry of the matrix is read once for all of
+    // them, and the K accumulators of a row are independent chains
+    template <std::size_t K>
+    void multiply (std::span<const std::array<value_type, K>> x, std::span<std::array<value_type, K>> y) const {
+        using detail::zmodule_access;
+        using traits = detail::lazy_accumulator<N>;
+        using wide_type = typename traits::type;
+
+        for_row_blocks([&](size_type lo, size_type hi){
+            for (size_type r=lo; r<hi; ++r){
+                const auto [first, length] = row_range(r);
+                const index_type *c = col.data() + first;
+                const value_type *a = val.data() + first;
+
+                std::array<wide_type, K> acc{};
+                for (size_type j=0; j<length; ){
+                    const size_type end = (length - j <= traits::terms) ? length : j + traits::terms;
+                    for (; j<end; ++j){
+                        const auto aj = static_cast<wide_type>(zmodule_access::residue(a[j]));
+                        const auto &xj = x[c[j]];
+                        for (std::size_t k=0; k<K; ++k)
+                            acc[k] += aj * zmodule_access::residue(xj[k]);
+                    }
+                    if (j < length)
+                        for (auto &e : acc)
+                            e = detail::reduce<N>(e);
+                }
+                for (std::size_t k=0; k<K; ++k)
+                    y[r][k] = assume_reduced<Integer>(detail::reduce<N>(acc[k]));
+            }
+        });
+    }
+
+    friend std::vector<value_type> operator* (const sparse_zmatrix &a, std::span<const value_type> x){
+        std::vector<value_type> y(a.n_rows);
+        a.multiply(x, y);
+        return y;
+    }
+
+private:
+    static constexpr auto N = value_type::N;
+
+    size_type n_rows = 0, n_cols = 0, nnz = 0;
+    sparse_layout storage = sparse_layout::csr;
+    size_type width = 0;                    // Length of the longest row
+    std::vector<size_type> row_start;       // CSR: entries of row r are [row_start[r], row_start[r+1])
+    std::vector<index_type> col;
+    std::vector<value_type> val;
+
+    // First entry and number of entries of row r
+    [[nodiscard]] std::pair<size_type, size_type> row_range (size_type r) const noexcept {
+        if (storage == sparse_layout::ell)
+            return {r*width, width};
+        return {row_start[r], row_start[r+1] - row_start[r]};
+    }
+
+    // First row whose entries start at or after entry e
+    [[nodiscard]] size_type row_boundary (size_type e) const noexcept {
+        if (e == 0)
+            return 0;
+        if (e == col.size())
+            return n_rows;
+        if (storage == sparse_layout::ell)
+            return (e + width - 1) / width;
+        return static_cast<size_type>(std::lower_bound(row_start.begin(), row_start.end(), e) - row_start.begin());
+    }
+
+    // Calls f(first_row, last_row) over blocks of rows with about the same
+    // number of entries, one per thread. Blocks cover every row, empty ones too
+    template <typename F>
+    void for_row_blocks (F &&f) const {
+        if (col.empty()){   // Nothing to balance, but the rows still have to be visited
+            f(size_type{0}, n_rows);
+            return;
+        }
+        detail::parallel_for(col.size(), [&](size_type lo, size_type hi){
+            f(row_boundary(lo), row_boundary(hi));
+        });
+    }
+
+    // Pads every row to the longest one. Padding points to column 0 with a
+    // zero value, so it doesn't change any product
+    void to_ell (){
+        std::vector<index_type> ell_col(n_rows*width, 0);
+        std::vector<value_type> ell_val(n_rows*width, value_type(0u));
+        for (size_type r=0; r<n_rows; ++r)
+            for (size_type j=row_start[r]; j<row_start[r+1]; ++j){
+                ell_col[r*width + j - row_start[r]] = col[j];
+                ell_val[r*width + j - row_start[r]] = val[j];
+            }
+
+        col = std::move(ell_col);
+        val = std::move(ell_val);
+        row_start = {};
+    }
+};
+
+// Minimal polynomial of the sequence u^T A^i v (i < 2n) for random vectors
+// u and v drawn from seed, found with Berlekamp-Massey (Wiedemann's
+// algorithm). It divides the minimal polynomial of A, and both are equal with
+// probability at least 1 - 2n/P, so a few seeds make failures negligible.
+// A has to be square and P prime
+template <std::integral auto P> requires (P > 1)
+[[nodiscard]] polynomial<P> minimal_polynomial (const sparse_zmatrix<P> &a,
+                                                std::uint64_t seed = counter_engine::default_seed)
+{
+    using value_type = ZModule<P>;
+    const std::size_t n = a.rows();
+
+    counter_engine engine(seed);
+    uniform_zmodule_distribution<P> dist;
+    std::vector<value_type> u(n), v(n), w(n);
+    dist.generate(u, engine);
+    dist.generate(v, engine);
+
+    using detail::zmodule_access;
+    using wide_type = typename detail::lazy_accumulator<value_type::N>::type;
+
+    std::vector<value_type> s(2*n);
+    for (std::size_t i=0; i<2*n; ++i){
+        if (i > 0){
+            a.multiply(v, w);
+            std::swap(v, w);
+        }
+        s[i] = assume_reduced<P>(detail::lazy_sum<value_type::N>(n, [&](std::size_t j){
+            return static_cast<wide_type>(zmodule_access::residue(u[j])) * zmodule_access::residue(v[j]);
+        }));
+    }
+
+    // x^k - c_0*x^{k-1} - ... - c_{k-1}
+    const auto c = berlekamp_massey<P>(s);
+    const std::size_t k = c.size();
+    std::vector<value_type> f(k+1);
+    for (std::size_t i=0; i<k; ++i)
+        f[k-1-i] = -c[i];
+    f[k] = value_type(1u);
+    return polynomial<P>(std::move(f));
+}
+
+}   // namespace fgs
+
+#endif
@@ -0,0 +1,115 @@
+#ifndef Z_MODULE_STATS_HPP__
+#define Z_MODULE_STATS_HPP__
+
+#include "z_module.hpp"
+
+#include <array>        // std::array
+#include <chrono>       // std::chrono::nanoseconds
+#include <cstddef>      // std::size_t
+#include <cstdint>      // std::uint64_t
+#include <string>       // std::string, std::to_string
+#include <vector>       // std::vector
+
+/* Public interface of the operation counters (see detail/stats_counters.hpp).
+ *
+ * They're only collected when FGS_STATS_SUPPORT is defined; otherwise
+ * snapshots are always empty.
+ */
+namespace fgs::stats{
+
+using operation = detail::stats::operation;
+
+inline constexpr bool enabled =
+#ifdef FGS_STATS_SUPPORT
+    true;
+#else
+    false;
+#endif
+
+// Only the expensive operations are timed, the rest are just counted
+[[nodiscard]] constexpr bool is_timed (operation op) noexcept {
+    return op == operation::inverse || op == operation::pow || op == operation::parse;
+}
+
+[[nodiscard]] constexpr const char* name (operation op) noexcept {
+    return detail::stats::operation_names[static_cast<std::size_t>(op)];
+}
+
+// Values aggregated over all threads for one modulus
+struct modulus_stats{
+    std::uint64_t modulus = 0;
+    detail::stats::totals values;
+
+    [[nodiscard]] std::uint64_t count (operation op) const noexcept {
+        return values.counts[static_cast<std::size_t>(op)];
+    }
+    [[nodiscard]] std::chrono::nanoseconds time (operation op) const noexcept {
+        return std::chrono::nanoseconds{values.nanoseconds[static_cast<std::size_t>(op)]};
+    }
+};
+
+struct report{
+    // Sorted by modulus
+    std::vector<modulus_stats> moduli;
+
+    // Stats of a modulus, nullptr if it wasn't used
+    [[nodiscard]] const modulus_stats* find (std::uint64_t modulus) const noexcept {
+        for (const auto &m : moduli)
+            if (m.modulus == modulus)
+                return &m;
+        return nullptr;
+    }
+
+    [[nodiscard]] std::string to_json () const {
+        std::string ret = std::string{"{\"enabled\":"} + (enabled ? "true" : "false") + ",\"moduli\":[";
+
+        for (std::size_t i=0; i<moduli.size(); ++i){
+            const auto &m = moduli[i];
+            ret += (i == 0) ? "{" : ",{";
+            ret += "\"modulus\":" + std::to_string(m.modulus);
+
+            ret += ",\"counts\":{";
+            for (std::size_t j=0; j<detail::stats::operation_count; ++j){
+                const auto op = static_cast<operation>(j);
+                ret += (j == 0) ? "\"" : ",\"";
+                ret += std::string{name(op)} + "\":" + std::to_string(m.count(op));
+            }
+
+            ret += "},\"nanoseconds\":{";
+            bool first = true;
+            for (std::size_t j=0; j<detail::stats::operation_count; ++j){
+                const auto op = static_cast<operation>(j);
+                if (!is_timed(op))
+                    continue;
+                ret += first ? "\"" : ",\"";
+                ret += std::string{name(op)} + "\":" + std::to_string(m.time(op).count());
+                first = false;
+            }
+            ret += "}}";
+        }
+
+        ret += "]}";
+        return ret;
+    }
+};
+
+// Aggregates the counters of every thread (finished ones included)
+[[nodiscard]] inline report snapshot (){
+    report ret;
+#ifdef FGS_STATS_SUPPORT
+    for (const auto &[modulus, values] : detail::stats::registry::instance().aggregate())
+        ret.moduli.push_back(modulus_stats{modulus, values});
+#endif
+    return ret;
+}
+
+// Sets every counter to zero
+inline void reset (){
+#ifdef FGS_STATS_SUPPORT
+    detail::stats::registry::instance().reset();
+#endif
+}
+
+}   // namespace fgs::stats
+
+#endif
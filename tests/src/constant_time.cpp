@@ -0,0 +1,145 @@
+#include <catch2/catch.hpp>
+#include "z_module.hpp"
+#include "z_module_constant_time.hpp"
+
+#include <cstdint>
+#include <limits>
+#include <sstream>
+#include <vector>
+
+namespace{
+    std::vector<std::uint64_t> pseudo_random(std::size_t n, std::uint64_t seed){
+        std::vector<std::uint64_t> v(n);
+        for (auto &e : v){
+            seed = seed*6364136223846793005ull + 1442695040888963407ull;
+            e = seed ^ (seed >> 29);
+        }
+        return v;
+    }
+
+    // Every operation against the fast z-module
+    template <auto N>
+    void check_against_fast(std::uint64_t x, std::uint64_t y){
+        using zm_t = fgs::Z<N>;
+        using ct_t = fgs::Z_ct<N>;
+
+        const zm_t a(x), b(y);
+        const ct_t ca(x), cb(y);
+        REQUIRE(zm_t(ca) == a);
+        REQUIRE(ct_t(a) == ca);
+
+        REQUIRE(zm_t(ca + cb) == a + b);
+        REQUIRE(zm_t(ca - cb) == a - b);
+        REQUIRE(zm_t(ca * cb) == a * b);
+        REQUIRE(zm_t(-ca) == -a);
+        REQUIRE(zm_t(ct_t(ca)++ + 0) == a);
+        REQUIRE(zm_t(++ct_t(ca)) == a + 1);
+        REQUIRE(zm_t(--ct_t(ca)) == a - 1);
+        REQUIRE(zm_t(ca ^ y) == (a ^ y));
+        REQUIRE(zm_t(ca ^ static_cast<std::uint8_t>(y)) == (a ^ static_cast<std::uint8_t>(y)));
+
+        if (std::gcd(static_cast<typename zm_t::value_type>(a), zm_t::N) == 1){
+            REQUIRE(ca.inverse() * ca == 1);
+            REQUIRE(zm_t(cb / ca) == b / a);
+            REQUIRE(zm_t(ca ^ -3) == (a ^ -3));
+        }
+    }
+
+    template <auto N>
+    void check_exhaustive(){
+        using zm_t = fgs::Z<N>;
+        for (std::uint64_t x=0; x<zm_t::N; ++x)
+            for (std::uint64_t y=0; y<zm_t::N; ++y)
+                check_against_fast<N>(x, y);
+    }
+
+    template <auto N>
+    void check_random(std::size_t n){
+        const auto x = pseudo_random(n, 1), y = pseudo_random(n, 2);
+        for (std::size_t i=0; i<n; ++i)
+            check_against_fast<N>(x[i], y[i]);
+
+        // The corners of the range
+        constexpr auto M = fgs::Z<N>::N;
+        check_against_fast<N>(0, M-1);
+        check_against_fast<N>(M-1, M-1);
+        check_against_fast<N>(1, M-2);
+    }
+}
+
+TEST_CASE("Constant-time operations on small moduli"){
+    check_exhaustive<3>();
+    check_exhaustive<15>();
+    check_exhaustive<97>();
+    check_exhaustive<3*5*7>();
+}
+
+TEST_CASE("Constant-time operations on big moduli"){
+    check_random<998244353u>(2000);
+    check_random<2147483647u>(2000);
+    check_random<4294967291u>(2000);
+    check_random<(1ull << 61) - 1>(2000);
+    check_random<18446744073709551557ull>(2000);   // 2^64 - 59
+    check_random<~std::uint64_t{0}>(2000);          // Composite, 3 * 5 * 17 * ...
+}
+
+TEST_CASE("Constant-time constructors and conversions"){
+    using ct_t = fgs::Z_ct<1000003>;
+    STATIC_REQUIRE(ct_t(-1) == ct_t(1000002));
+    STATIC_REQUIRE(ct_t(std::numeric_limits<std::int64_t>::min()) == fgs::Z<1000003>(std::numeric_limits<std::int64_t>::min()));
+    STATIC_REQUIRE(ct_t(std::numeric_limits<std::uint64_t>::max()) == fgs::Z<1000003>(std::numeric_limits<std::uint64_t>::max()));
+    STATIC_REQUIRE(static_cast<int>(ct_t(std::int8_t{-128})) == 1000003 - 128);
+    STATIC_REQUIRE(static_cast<unsigned>(ct_t(5) * 3 - 15) == 0);
+    STATIC_REQUIRE(ct_t(0) - 1 == -1);
+    STATIC_REQUIRE(fgs::Z_ct<7>{true} == 1);
+
+    // 64 bits signed values against 32 bits words
+    STATIC_REQUIRE(fgs::Z_ct<7>{std::int64_t{-1}} == 6);
+    STATIC_REQUIRE(fgs::Z_ct<998244353>{std::int64_t{-5}} == 998244348);
+    STATIC_REQUIRE(fgs::Z_ct<998244353>{-1000000000000LL} == fgs::Z<998244353>{-1000000000000LL});
+    STATIC_REQUIRE((fgs::Z_ct<998244353>{3} ^ -1LL) == 332748118);
+    STATIC_REQUIRE((fgs::Z_ct<998244353>{3} ^ std::int64_t{-5}) == fgs::Z_ct<998244353>{3}.inverse() ^ 5);
+    STATIC_REQUIRE((ct_t(2) ^ static_cast<signed char>(-3)) == ct_t(8).inverse());
+    STATIC_REQUIRE(ct_t(false) == 0);
+    STATIC_REQUIRE(ct_t(1) == true);
+    STATIC_REQUIRE((ct_t(5) ^ true) == 5);
+    STATIC_REQUIRE(fgs::is_constant_time_z_module<ct_t>);
+    STATIC_REQUIRE(!fgs::is_constant_time_z_module<fgs::Z<1000003>>);
+
+    // Powers, inverses and selections are constexpr too
+    STATIC_REQUIRE((ct_t(2) ^ 20) == 1048576 % 1000003);
+    STATIC_REQUIRE(ct_t(12345).inverse() * 12345 == 1);
+    STATIC_REQUIRE(select(true, ct_t(1), ct_t(2)) == 1);
+    STATIC_REQUIRE(select(false, ct_t(1), ct_t(2)) == 2);
+
+    std::stringstream ss;
+    ss << ct_t(-2);
+    REQUIRE(ss.str() == "1000001");
+    ct_t read;
+    ss >> read;
+    REQUIRE(read == -2);
+}
+
+TEST_CASE("Constant-time inversion bounds"){
+    // Bernstein-Yang's bound, 187 steps for 64 bits inputs
+    STATIC_REQUIRE(fgs::Z_ct<~std::uint64_t{0}>::divsteps == 187);
+    STATIC_REQUIRE(fgs::Z_ct<3>::divsteps == 10);
+
+    // Values with long runs of equal bits, which need the most steps to be halved away
+    using ct_t = fgs::Z_ct<18446744073709551557ull>;
+    using ct32_t = fgs::Z_ct<4294967291u>;
+    for (int k=1; k<64; ++k){
+        const std::uint64_t x = std::uint64_t(1) << k;
+        REQUIRE(ct_t(x).inverse() * x == 1);
+        REQUIRE(ct_t(x-1).inverse() * (x-1) == 1);
+        REQUIRE(ct32_t(x).inverse() * x == 1);
+        REQUIRE(ct32_t(x+1).inverse() * (x+1) == 1);
+    }
+
+#ifdef FGS_EXCEPTIONS_SUPPORT
+    REQUIRE_THROWS_AS(ct_t(0).inverse(), std::domain_error);
+    REQUIRE_THROWS_AS(fgs::Z_ct<15>(6) / fgs::Z_ct<15>(5), std::domain_error);
+    REQUIRE_THROWS_AS(fgs::Z_ct<15>(5) ^ -1, std::domain_error);
+    REQUIRE((fgs::Z_ct<15>(5) ^ 2) == 10);
+#endif
+}
@@ -0,0 +1,80 @@
+#include <catch2/catch.hpp>
+#include "z_module.hpp"
+#include "z_module_bulk.hpp"
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <vector>
+
+namespace{
+    // Bulk conversion has to match the per-element constructor
+    template <auto N, typename T>
+    void check_reduce_into(){
+        using zm_t = fgs::Z<N>;
+        std::vector<T> in{
+            std::numeric_limits<T>::min(), std::numeric_limits<T>::max(),
+            T(0), T(1), T(-1), T(100), T(-100), T(static_cast<T>(N)), T(-static_cast<T>(N))
+        };
+        std::uint64_t x = 0x13198A2E03707344ull;
+        for (int i=0; i<1000; ++i){
+            x = x*6364136223846793005ull + 1442695040888963407ull;
+            in.push_back(static_cast<T>(x >> 7));
+        }
+
+        std::vector<zm_t> out(in.size());
+        fgs::reduce_into(in, out);
+        for (std::size_t i=0; i<in.size(); ++i)
+            REQUIRE(out[i] == zm_t{in[i]});
+
+        std::vector<std::uint64_t> back(out.size());
+        fgs::lift_from(out, back);
+        for (std::size_t i=0; i<out.size(); ++i)
+            REQUIRE(back[i] == static_cast<std::uint64_t>(out[i]));
+    }
+
+    template <auto N>
+    void check_all_types(){
+        check_reduce_into<N, signed char>();
+        check_reduce_into<N, unsigned char>();
+        check_reduce_into<N, short>();
+        check_reduce_into<N, unsigned short>();
+        check_reduce_into<N, int>();
+        check_reduce_into<N, unsigned>();
+        check_reduce_into<N, std::int64_t>();
+        check_reduce_into<N, std::uint64_t>();
+    }
+}
+
+TEST_CASE("Bulk conversion from integers"){
+    check_all_types<2>();
+    check_all_types<7>();
+    check_all_types<1237>();
+    check_all_types<1u<<16>();
+    check_all_types<998244353u>();
+    check_all_types<(1ull<<61)-1>();
+    check_all_types<18446744073709551557ull>();
+}
+
+TEST_CASE("Bulk conversion from bools"){
+    using zm_t = fgs::Z<7>;
+    const std::array<bool, 4> in{true, false, false, true};
+    std::array<zm_t, 4> out;
+    fgs::reduce_into(in, out);
+    for (std::size_t i=0; i<4; ++i)
+        REQUIRE(out[i] == zm_t{in[i]});
+}
+
+TEST_CASE("Bulk conversions take spans and containers alike"){
+    using zm_t = fgs::Z<1237>;
+    std::vector<int> in{-1, 0, 1236, 1237, -5000};
+    std::vector<zm_t> out(in.size()), expected(in.size());
+    fgs::reduce_into(std::span<const int>{in}, std::span<zm_t>{expected});
+    fgs::reduce_into(std::span<int>{in}, out);
+    REQUIRE(out == expected);
+
+    std::array<short, 5> back{};
+    fgs::lift_from(std::span<zm_t>{out}, std::span<short>{back});
+    REQUIRE(back == std::array<short, 5>{1236, 0, 1236, 0, 1185});
+}
@@ -0,0 +1,134 @@
+#include <catch2/catch.hpp>
+#include "z_module.hpp"
+#include "z_module_crt.hpp"
+
+#include <array>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+namespace{
+    template <auto N>
+    std::vector<fgs::Z<N>> pseudo_random(std::size_t n, std::uint64_t seed){
+        std::vector<fgs::Z<N>> v(n);
+        for (auto &e : v){
+            seed = seed*6364136223846793005ull + 1442695040888963407ull;
+            e = fgs::Z<N>{seed ^ (seed >> 29)};
+        }
+        return v;
+    }
+
+    // Every element of a small ring, checked against brute force
+    template <auto N>
+    void check_exhaustive(){
+        using crt = fgs::crt_view<N>;
+        using zm_t = fgs::Z<N>;
+
+        std::vector<bool> is_square(zm_t::N, false);
+        for (unsigned x=0; x<zm_t::N; ++x)
+            is_square[static_cast<unsigned>(zm_t(x)*zm_t(x))] = true;
+
+        for (unsigned x=0; x<zm_t::N; ++x){
+            const zm_t zx(x);
+            REQUIRE(crt::recombine(crt::decompose(zx)) == zx);
+            REQUIRE(crt::is_unit(zx) == (std::gcd(x, static_cast<unsigned>(zm_t::N)) == 1));
+            if (crt::is_unit(zx))
+                REQUIRE(crt::inverse(zx) * zx == 1);
+
+            const auto root = crt::sqrt(zx);
+            REQUIRE(root.has_value() == is_square[x]);
+            if (root)
+                REQUIRE(*root * *root == zx);
+        }
+    }
+}
+
+TEST_CASE("Compile-time factorization"){
+    using small = fgs::crt_view<360>;
+    STATIC_REQUIRE(small::components == 3);
+    STATIC_REQUIRE(small::primes == std::array<unsigned, 3>{2, 3, 5});
+    STATIC_REQUIRE(small::exponents == std::array{3, 2, 1});
+    STATIC_REQUIRE(small::moduli == std::array<unsigned, 3>{8, 9, 5});
+    STATIC_REQUIRE(std::same_as<small::component_type<1>, fgs::Z<9u>>);
+    STATIC_REQUIRE(std::same_as<fgs::crt_view<(1ull<<40)*3>::component_type<0>, fgs::Z<(1ull<<40)>>);
+    STATIC_REQUIRE(std::same_as<fgs::crt_view<(1ull<<40)*3>::component_type<1>, fgs::Z<3u>>);
+
+    // 2^64 - 1 = 3 * 5 * 17 * 257 * 641 * 65537 * 6700417
+    using all_ones = fgs::crt_view<~std::uint64_t{0}>;
+    STATIC_REQUIRE(all_ones::components == 7);
+    STATIC_REQUIRE(all_ones::primes[5] == 65537);
+    STATIC_REQUIRE(all_ones::primes[6] == 6700417);
+
+    // Two big prime factors, beyond trial division
+    using semiprime = fgs::crt_view<4294967291ull * 2147483647ull>;
+    STATIC_REQUIRE(semiprime::moduli[0] == 2147483647ull && semiprime::moduli[1] == 4294967291ull);
+
+    using prime = fgs::crt_view<18446744073709551557ull>;
+    STATIC_REQUIRE(prime::components == 1);
+
+    using power = fgs::crt_view<1u << 20>;
+    STATIC_REQUIRE(power::components == 1);
+    STATIC_REQUIRE(power::exponents[0] == 20);
+}
+
+TEST_CASE("Element-wise CRT operations"){
+    check_exhaustive<360>();
+    check_exhaustive<2*2*2*2*2*2 * 27 * 49>();
+    check_exhaustive<1u << 10>();
+    check_exhaustive<3*3*3*3*3*3>();
+    check_exhaustive<2*17>();
+    check_exhaustive<97>();
+}
+
+TEST_CASE("CRT operations on big moduli"){
+    constexpr auto N = ~std::uint64_t{0};
+    using crt = fgs::crt_view<N>;
+
+    for (const auto &x : pseudo_random<N>(2000, 7)){
+        REQUIRE(crt::recombine(crt::decompose(x)) == x);
+        if (crt::is_unit(x))
+            REQUIRE(crt::inverse(x) * x == 1);
+
+        const auto square = x*x;
+        const auto root = crt::sqrt(square);
+        REQUIRE(root.has_value());
+        REQUIRE(*root * *root == square);
+    }
+}
+
+TEST_CASE("Arrays in CRT form"){
+    constexpr auto N = 16ull * 9ull * 1000003ull * 2147483647ull;
+    using crt = fgs::crt_view<N>;
+
+    // Big enough to be processed in parallel
+    const std::size_t n = 100000;
+    auto a = pseudo_random<N>(n, 1), b = pseudo_random<N>(n, 2);
+    for (auto &e : b)
+        if (!crt::is_unit(e))
+            e = fgs::Z<N>(1u);
+
+    crt::vector va(a), vb(b);
+    REQUIRE(va.size() == n);
+    REQUIRE(va.values() == a);
+    REQUIRE(va.component<0>()[5] == static_cast<std::uint64_t>(a[5]) % 16);
+    REQUIRE(va.component<3>()[5] == static_cast<std::uint64_t>(a[5]) % 2147483647ull);
+
+    const auto sum = (va + vb).values(), diff = (va - vb).values(), prod = (va * vb).values();
+    vb.invert();
+    const auto inv = vb.values();
+    for (std::size_t i=0; i<n; ++i){
+        REQUIRE(sum[i] == a[i] + b[i]);
+        REQUIRE(diff[i] == a[i] - b[i]);
+        REQUIRE(prod[i] == a[i] * b[i]);
+        REQUIRE(inv[i] * b[i] == 1);
+    }
+
+    crt::vector small(std::vector<fgs::Z<N>>(a.begin(), a.begin()+10));
+    small.for_each_component([](auto c){
+        REQUIRE(c.size() == 10);
+        for (auto &e : c)
+            e += std::remove_cvref_t<decltype(e)>(1u);
+    });
+    for (std::size_t i=0; i<10; ++i)
+        REQUIRE(small.values()[i] == a[i] + 1);
+}
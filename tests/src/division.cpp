@@ -0,0 +1,26 @@
+#include <catch2/catch.hpp>
+#include "z_module.hpp"
+
+TEST_CASE("Division operator /"){
+    SECTION("Small prime modulus"){
+        fgs::Z<1237> a{1000};
+        for (int i=1; i<1237; ++i)
+            REQUIRE((a/i)*i == a);
+    }
+
+    SECTION("Composite modulus with invertible divisor"){
+        fgs::Z<1000> a{999};
+        REQUIRE(a/fgs::Z<1000>{7}*7 == a);
+        REQUIRE(fgs::Z<1000>{1}/fgs::Z<1000>{3} == 667);
+    }
+
+    SECTION("Big moduli"){
+        using big = fgs::Z<(1ull<<61)-1>;
+        const big b{123456789123456789ull};
+        REQUIRE(big{1u}/b*b == 1u);
+
+        using huge = fgs::Z<18446744073709551557ull>;
+        const huge h{18446744073709551000ull};
+        REQUIRE(huge{1u}/h*h == 1u);
+    }
+}
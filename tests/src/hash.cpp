@@ -0,0 +1,86 @@
+#include <catch2/catch.hpp>
+#include "z_module.hpp"
+#include "z_module_rolling_hash.hpp"
+
+#include <array>
+#include <ranges>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <unordered_set>
+#include <vector>
+
+TEST_CASE("std::hash specialization"){
+    std::unordered_set<fgs::Z<1237>> set;
+    set.insert(fgs::Z<1237>{10});
+    set.insert(fgs::Z<1237>{1247});
+    set.insert(fgs::Z<1237>{-1227});
+    set.insert(fgs::Z<1237>{11});
+
+    REQUIRE(set.size() == 2);
+    REQUIRE(set.count(fgs::Z<1237>{10}) == 1);
+    REQUIRE(std::hash<fgs::Z<1237>>{}(fgs::Z<1237>{2484}) == std::hash<fgs::Z<1237>>{}(fgs::Z<1237>{10}));
+}
+
+TEST_CASE("Rolling hash"){
+    using hash_t = fgs::rolling_hash<(1ull<<61)-1, 131>;
+    const std::string text{"abracadabra"};
+    const hash_t h{text};
+
+    REQUIRE(h.size() == text.size());
+    REQUIRE(h.hash() == hash_t::hash_of(text));
+    REQUIRE(h(0, 4) == hash_t::hash_of(std::string_view{"abra"}));
+    REQUIRE(h(0, 4) == h(7, 4));
+    REQUIRE(h(0, 4) != h(1, 4));
+    REQUIRE(h(3, 0) == 0);
+    REQUIRE(h.power(2) == 131*131);
+
+    SECTION("Long inputs match the sequential computation"){
+        std::string long_text;
+        for (int i=0; i<20011; ++i)
+            long_text += static_cast<char>('a' + (i*i+7*i)%26);
+
+        const hash_t lh{long_text};
+        for (std::size_t pos : {0ul, 1ul, 2501ul, 2502ul, 9999ul, 19000ul})
+            REQUIRE(lh(pos, 1000) == hash_t::hash_of(std::string_view{long_text}.substr(pos, 1000)));
+        REQUIRE(lh.hash() == hash_t::hash_of(long_text));
+    }
+}
+
+TEST_CASE("Double rolling hash"){
+    using hash_t = fgs::double_rolling_hash<1000000007, 131, 998244353, 137>;
+    const hash_t h{std::string{"abracadabra"}};
+
+    REQUIRE(h(0, 4) == h(7, 4));
+    REQUIRE(h(0, 4) == hash_t::hash_of(std::string_view{"abra"}));
+    REQUIRE(h(0, 4) != h(1, 4));
+
+    // Same values as the hashes built on their own
+    const std::string text{"abracadabra"};
+    const fgs::rolling_hash<1000000007, 131> first{text};
+    const fgs::rolling_hash<998244353, 137> second{text};
+    REQUIRE(h.hash() == std::tuple{first.hash(), second.hash()});
+    REQUIRE(h(3, 5) == std::tuple{first(3, 5), second(3, 5)});
+    STATIC_REQUIRE(hash_t::hash_of(std::string_view{"abra"}) ==
+                   std::tuple{fgs::rolling_hash<1000000007, 131>::hash_of(std::string_view{"abra"}),
+                              fgs::rolling_hash<998244353, 137>::hash_of(std::string_view{"abra"})});
+
+    // The input is read only once for all the hashes
+    std::size_t reads = 0;
+    const auto counted = text | std::views::transform([&reads](char c){ ++reads; return c; });
+    const hash_t from_view{counted};
+    REQUIRE(reads == text.size());
+    REQUIRE(from_view.hash() == h.hash());
+}
+
+TEST_CASE("Rolling hash of bools"){
+    using hash_t = fgs::rolling_hash<1000000007, 2>;
+    const std::vector<bool> bits{true, false, true, true, false, true, true};
+    const hash_t h{bits};
+
+    REQUIRE(h.hash() == 0b1011011);
+    REQUIRE(h(2, 3) == 0b110);
+    REQUIRE(h(5, 2) == h(2, 2));
+    REQUIRE(hash_t::hash_of(std::vector<bool>{true, false, true}) == 0b101);
+    STATIC_REQUIRE(hash_t::hash_of(std::array<bool, 2>{true, true}) == 3);
+}
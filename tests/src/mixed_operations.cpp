@@ -0,0 +1,89 @@
+#include <catch2/catch.hpp>
+#include "z_module.hpp"
+
+#include <cstdint>
+#include <limits>
+
+namespace{
+    // Mixed operations must give the same results as building the z-module first
+    template <auto N, typename T>
+    void check_mixed(const T &x){
+        using zm_t = fgs::Z<N>;
+        const zm_t a{std::uint64_t{0x9E3779B97F4A7C15ull}};
+        const zm_t b{x};
+
+        REQUIRE((a == x) == (a == b));
+        REQUIRE((a != x) == (a != b));
+        REQUIRE((a <  x) == (a <  b));
+        REQUIRE((a >= x) == (a >= b));
+        REQUIRE((x == a) == (b == a));
+        REQUIRE((x <= a) == (b <= a));
+        REQUIRE(b == x);
+        REQUIRE(x == b);
+
+        REQUIRE(a + x == a + b);
+        REQUIRE(a - x == a - b);
+        REQUIRE(a * x == a * b);
+        REQUIRE(x + a == b + a);
+        REQUIRE(x - a == b - a);
+        REQUIRE(x * a == b * a);
+    }
+
+    template <auto N>
+    void check_values(){
+        // Computed in unsigned arithmetic, so moduli near 2^64 just wrap around
+        const auto n = static_cast<std::uint64_t>(fgs::Z<N>::N);
+        const std::uint64_t values[] = {0, 1, 10, ~std::uint64_t{0}, ~std::uint64_t{9}, n-1, n, n+1,
+                                        std::uint64_t{1} << 63, (std::uint64_t{1} << 63) - 1};
+        for (const std::uint64_t u : values){
+            const auto x = static_cast<std::int64_t>(u);
+            check_mixed<N>(x);
+            check_mixed<N>(static_cast<std::uint64_t>(x));
+            check_mixed<N>(static_cast<std::int8_t>(x));
+            check_mixed<N>(static_cast<std::uint8_t>(x));
+            check_mixed<N>(static_cast<std::int32_t>(x));
+        }
+    }
+}
+
+TEST_CASE("Mixed operations match the reduced ones"){
+    check_values<7>();
+    check_values<1237>();
+    check_values<1u<<16>();
+    check_values<1ull<<63>();
+    check_values<(1ull<<61)-1>();
+    check_values<18446744073709551557ull>();
+    check_values<static_cast<std::uint8_t>(200)>();
+}
+
+TEST_CASE("Small integral types"){
+    using small = fgs::Z<1000000007>;
+    REQUIRE(small(std::int8_t{-128}) == small(-128));
+    REQUIRE(small(std::int16_t{-1}) == small(1000000006));
+    REQUIRE(small(std::uint16_t{65535}) == 65535);
+    REQUIRE(small(true) == 1);
+    REQUIRE((small(5) ^ true) == 5);
+    REQUIRE((small(5) ^ false) == 1);
+    REQUIRE((small(3) ^ std::int8_t{-1}) == small(1)/3);
+
+    using two = fgs::Z<1u<<16>;
+    REQUIRE(two(std::int8_t{-1}) == 65535);
+    REQUIRE(two(std::int64_t{-65537}) == 65535);
+    REQUIRE(two(std::numeric_limits<std::int64_t>::min()) == 0);
+
+    STATIC_REQUIRE(fgs::Z<300>(std::int8_t{-128}) == 172);
+    STATIC_REQUIRE(fgs::Z<7>(-1) == 6);
+    STATIC_REQUIRE((fgs::Z<7>(3) ^ true) == 3);
+}
+
+TEST_CASE("Elements built without reduction"){
+    using zm_t = fgs::Z<1237>;
+    STATIC_REQUIRE(fgs::assume_reduced<1237>(1236) == zm_t(-1));
+    STATIC_REQUIRE(fgs::assume_reduced<1237>(0u) == zm_t(1237));
+    REQUIRE(fgs::assume_reduced_checked<1237>(std::int8_t{100}) == 100);
+
+#ifdef FGS_EXCEPTIONS_SUPPORT
+    REQUIRE_THROWS_AS(fgs::assume_reduced_checked<1237>(1237), std::out_of_range);
+    REQUIRE_THROWS_AS(fgs::assume_reduced_checked<1237>(-1), std::out_of_range);
+#endif
+}
@@ -0,0 +1,103 @@
+#include <catch2/catch.hpp>
+#include "z_module.hpp"
+#include "z_module_polynomial.hpp"
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace{
+    template <auto P>
+    std::vector<fgs::Z<P>> random_coefficients(std::size_t n, std::uint64_t seed){
+        std::vector<fgs::Z<P>> v(n);
+        for (auto &e : v){
+            seed = seed*6364136223846793005ull + 1442695040888963407ull;
+            e = fgs::Z<P>{seed >> 11};
+        }
+        if (n > 0 && v.back() == 0)
+            v.back() = fgs::Z<P>{1u};
+        return v;
+    }
+
+    template <auto P>
+    void check_multiplication(std::size_t n, std::size_t m){
+        const auto a = random_coefficients<P>(n, 1);
+        const auto b = random_coefficients<P>(m, 2);
+        const auto naive = fgs::detail::multiply_naive<P>(a, b);
+
+        REQUIRE((fgs::polynomial<P>(a) * fgs::polynomial<P>(b)).coefficients() == naive);
+        REQUIRE(fgs::detail::multiply_karatsuba<P>(a, b) == naive);
+    }
+}
+
+TEST_CASE("Polynomial basics"){
+    using poly = fgs::polynomial<998244353u>;
+    using zm_t = fgs::Z<998244353u>;
+
+    const poly p{zm_t{1}, zm_t{2}, zm_t{3}};  // 1 + 2x + 3x^2
+
+    REQUIRE(p.degree() == 2);
+    REQUIRE(poly{}.degree() == -1);
+    REQUIRE(p(zm_t{2}) == 17);
+    REQUIRE(p.derivative() == poly{zm_t{2}, zm_t{6}});
+    REQUIRE((p - p).is_zero());
+    REQUIRE(p*zm_t{2} == p + p);
+}
+
+TEST_CASE("Polynomial multiplication"){
+    // NTT friendly prime
+    check_multiplication<998244353u>(1000, 777);
+    check_multiplication<998244353u>(3000, 20);
+    // Multi-modular
+    check_multiplication<1000000007u>(1000, 777);
+    check_multiplication<1000000007u>(300, 200);    // Karatsuba
+    check_multiplication<1000000007u>(3000, 100);
+    check_multiplication<(1ull<<61)-1>(700, 600);
+    check_multiplication<18446744073709551557ull>(1000, 600);
+    // Composite with 2^9 | P-1 (1537 = 29*53), which can't use the NTT
+    check_multiplication<1537u>(100, 100);
+    check_multiplication<1537u>(1000, 777);
+}
+
+TEST_CASE("Power series inverse"){
+    using poly = fgs::polynomial<998244353u>;
+    const poly f{random_coefficients<998244353u>(500, 3)};
+    const poly g = f.inverse_series(700);
+
+    auto fg = (f*g).coefficients();
+    fg.resize(700);
+    REQUIRE(fg[0] == 1);
+    for (std::size_t i=1; i<fg.size(); ++i)
+        REQUIRE(fg[i] == 0);
+}
+
+TEST_CASE("Polynomial division"){
+    using poly = fgs::polynomial<1000000007u>;
+    const poly a{random_coefficients<1000000007u>(2000, 4)};
+
+    for (std::size_t m : {1ul, 10ul, 500ul, 1900ul, 2000ul, 2500ul}){
+        const poly b{random_coefficients<1000000007u>(m, 5+m)};
+        const auto [q, r] = divmod(a, b);
+
+        REQUIRE(r.degree() < b.degree());
+        REQUIRE(q*b + r == a);
+    }
+}
+
+TEST_CASE("Multipoint evaluation and interpolation"){
+    using poly = fgs::polynomial<998244353u>;
+    using zm_t = fgs::Z<998244353u>;
+
+    const poly p{random_coefficients<998244353u>(1000, 6)};
+    std::vector<zm_t> points;
+    for (int i=0; i<1500; ++i)
+        points.emplace_back(i*i + 7*i + 1);
+
+    const auto values = p.evaluate(points);
+    for (std::size_t i=0; i<points.size(); ++i)
+        REQUIRE(values[i] == p(points[i]));
+
+    const std::span<const zm_t> xs{points.data(), 1000};
+    const std::span<const zm_t> ys{values.data(), 1000};
+    REQUIRE(poly::interpolate(xs, ys) == p);
+}
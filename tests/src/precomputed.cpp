@@ -0,0 +1,81 @@
+#include <catch2/catch.hpp>
+#include "z_module.hpp"
+#include "z_module_bulk.hpp"
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace{
+    template <auto N>
+    void check_precomputed(){
+        using zm_t = fgs::Z<N>;
+
+        std::uint64_t x = 0x243F6A8885A308D3ull;
+        auto next = [&x]{ x = x*6364136223846793005ull + 1442695040888963407ull; return x >> 1; };
+
+        for (int i=0; i<50; ++i){
+            const zm_t w{next()};
+            const fgs::mul_const<N> pw{w};
+
+            REQUIRE(pw.value() == w);
+            for (int j=0; j<50; ++j){
+                zm_t a{next()};
+                REQUIRE(a*pw == a*w);
+                REQUIRE(pw*a == a*w);
+                REQUIRE((a*=pw) == (a*w));
+            }
+        }
+
+        // Extreme values
+        const zm_t max{N-1};
+        REQUIRE(max*fgs::mul_const<N>{max} == zm_t{1u});
+        REQUIRE(max*fgs::mul_const<N>{zm_t{0u}} == zm_t{0u});
+    }
+}
+
+TEST_CASE("Shoup multiplication matches the generic one"){
+    check_precomputed<1237>();
+    check_precomputed<1000000007u>();
+    check_precomputed<(1u<<31)-1>();
+    check_precomputed<(1ull<<61)-1>();
+    check_precomputed<(1ull<<63)+29>();  // Too big for Shoup, fallback
+    check_precomputed<18446744073709551557ull>();
+    check_precomputed<1u<<16>();
+}
+
+TEST_CASE("Span kernels"){
+    using zm_t = fgs::Z<998244353u>;
+    std::vector<zm_t> x, y;
+    for (int i=0; i<100; ++i){
+        x.emplace_back(i*i + 12345);
+        y.emplace_back(i);
+    }
+    const zm_t w{123456789};
+
+    std::vector<zm_t> out(x.size());
+    fgs::scale(x, w, out);
+    for (std::size_t i=0; i<x.size(); ++i)
+        REQUIRE(out[i] == x[i]*w);
+
+    std::vector<zm_t> z = y;
+    fgs::axpy(w, x, z);
+    for (std::size_t i=0; i<x.size(); ++i)
+        REQUIRE(z[i] == y[i] + w*x[i]);
+
+    // Spans still pick the span kernels, const or not
+    std::vector<zm_t> z2 = y;
+    fgs::axpy(fgs::mul_const<998244353u>{w}, std::span<const zm_t>{x}, std::span<zm_t>{z2});
+    REQUIRE(z2 == z);
+    fgs::scale(std::span<zm_t>{z2}.first(50), w, std::span<zm_t>{z2}.first(50));
+    for (std::size_t i=0; i<50; ++i)
+        REQUIRE(z2[i] == z[i]*w);
+
+    fgs::scale(x, fgs::mul_const<998244353u>{w});
+    REQUIRE(x == out);
+
+    std::array<zm_t, 3> a{zm_t{1}, zm_t{2}, zm_t{3}};
+    fgs::scale(std::span<zm_t>{a}, w);
+    REQUIRE(a[2] == w*3);
+}
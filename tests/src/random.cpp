@@ -0,0 +1,103 @@
+#include <catch2/catch.hpp>
+#include "z_module.hpp"
+#include "z_module_random.hpp"
+
+#include <array>
+#include <cstdint>
+#include <random>
+#include <sstream>
+#include <vector>
+
+namespace{
+    // Pearson's chi-squared statistic of the samples over k buckets
+    template <auto N, typename G>
+    double chi_squared(G &g, std::size_t samples, std::size_t buckets){
+        fgs::uniform_zmodule_distribution<N> dist;
+        std::vector<double> count(buckets, 0.0);
+        const auto n = static_cast<double>(fgs::Z<N>::N);
+        for (std::size_t i=0; i<samples; ++i){
+            const auto x = static_cast<double>(static_cast<typename fgs::Z<N>::value_type>(dist(g)));
+            ++count[static_cast<std::size_t>(x / n * static_cast<double>(buckets))];
+        }
+
+        const double expected = static_cast<double>(samples) / static_cast<double>(buckets);
+        double chi = 0;
+        for (const double c : count)
+            chi += (c - expected) * (c - expected) / expected;
+        return chi;
+    }
+
+    // Bulk generation gives the same samples as the one by one path
+    template <auto N>
+    void check_bulk(){
+        fgs::uniform_zmodule_distribution<N> dist;
+        fgs::counter_engine g1(42, 3), g2(42, 3);
+
+        std::vector<fgs::Z<N>> bulk(1000);
+        dist.generate(bulk, g1);
+        for (const auto &e : bulk)
+            REQUIRE(e == dist(g2));
+        REQUIRE(g1 == g2);
+    }
+}
+
+TEST_CASE("Counter-based engine"){
+    STATIC_REQUIRE(std::uniform_random_bit_generator<fgs::counter_engine>);
+
+    fgs::counter_engine a(1234), b(1234), c(1234, 1);
+    std::array<std::uint64_t, 100> block;
+    b.generate(block);
+    for (const auto x : block){
+        REQUIRE(x == a());
+        REQUIRE(x != c());
+    }
+
+    a.discard(1000);
+    for (int i=0; i<1000; ++i)
+        b();
+    REQUIRE(a == b);
+    REQUIRE(a() == b());
+
+    std::stringstream ss;
+    ss << a;
+    fgs::counter_engine d;
+    ss >> d;
+    REQUIRE(d == a);
+    REQUIRE(d() == a());
+}
+
+TEST_CASE("Uniform z-module distribution"){
+    using dist_t = fgs::uniform_zmodule_distribution<7>;
+    dist_t dist;
+    REQUIRE(dist.min() == 0);
+    REQUIRE(dist.max() == 6);
+    REQUIRE(dist == dist_t(dist.param()));
+
+    std::stringstream ss;
+    ss << dist;
+    ss >> dist;
+    REQUIRE(!ss.fail());
+
+    fgs::uniform_zmodule_distribution<11> other;
+    ss.clear(); ss.str(""); ss << other;
+    ss >> dist;
+    REQUIRE(ss.fail());
+
+    // 99.9% quantiles: 27.88 (9 degrees of freedom), 148.2 (99 degrees)
+    fgs::counter_engine g(7);
+    std::mt19937 mt(7);
+    std::ranlux24_base ranlux(7);     // 24 bits words, through std::uniform_int_distribution
+    REQUIRE(chi_squared<7>(g, 70000, 7) < 22.46);       // 6 degrees of freedom
+    REQUIRE(chi_squared<7>(mt, 70000, 7) < 22.46);
+    REQUIRE(chi_squared<7>(ranlux, 70000, 7) < 22.46);
+    REQUIRE(chi_squared<(1ull<<63) + 1>(g, 100000, 100) < 148.2);
+    REQUIRE(chi_squared<(1ull<<63) + 1>(mt, 100000, 100) < 148.2);
+    REQUIRE(chi_squared<3000000019u>(mt, 100000, 10) < 27.88);
+}
+
+TEST_CASE("Bulk generation matches single samples"){
+    check_bulk<7>();
+    check_bulk<1u << 20>();
+    check_bulk<(1ull<<63) + 1>();     // Almost half of the words are rejected
+    check_bulk<18446744073709551557ull>();
+}
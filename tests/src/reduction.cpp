@@ -0,0 +1,84 @@
+#include <catch2/catch.hpp>
+#include "z_module.hpp"
+
+#include <cstdint>
+#include <limits>
+#include <string>
+
+namespace{
+    using u128 = fgs::detail::uint128_t;
+
+    // Reference arithmetic done with the generic % in 128 bits
+    template <auto N>
+    void check_against_reference(){
+        using zm_t = fgs::Z<N>;
+        using value_type = typename zm_t::value_type;
+        const u128 mod = static_cast<u128>(zm_t::N);
+
+        std::uint64_t x = 0x9E3779B97F4A7C15ull;
+        for (int i=0; i<2000; ++i){
+            x = x*6364136223846793005ull + 1442695040888963407ull;
+            const std::uint64_t y = x ^ (x >> 29);
+
+            const zm_t a{x}, b{y};
+            const u128 ra = x % mod, rb = y % mod;
+
+            REQUIRE(static_cast<value_type>(a) == static_cast<value_type>(ra));
+            REQUIRE(static_cast<value_type>(a+b) == static_cast<value_type>((ra+rb) % mod));
+            REQUIRE(static_cast<value_type>(a-b) == static_cast<value_type>((ra+mod-rb) % mod));
+            REQUIRE(static_cast<value_type>(a*b) == static_cast<value_type>((ra*rb) % mod));
+
+            const auto s = static_cast<std::int64_t>(x);
+            const u128 rs = (s < 0) ? (mod - (static_cast<u128>(-(s+1))+1) % mod) % mod
+                                    : static_cast<u128>(s) % mod;
+            REQUIRE(static_cast<value_type>(zm_t{s}) == static_cast<value_type>(rs));
+        }
+    }
+}
+
+TEST_CASE("Modulus classification"){
+    STATIC_REQUIRE(fgs::detail::modulus_traits<(1ull<<61)-1>::is_pseudo_mersenne);
+    STATIC_REQUIRE(fgs::detail::modulus_traits<(1u<<31)-1>::is_pseudo_mersenne);
+    STATIC_REQUIRE(fgs::detail::modulus_traits<18446744073709551557ull>::is_pseudo_mersenne);
+    STATIC_REQUIRE(fgs::detail::modulus_traits<18446744073709551557ull>::c == 59);
+    STATIC_REQUIRE(fgs::detail::modulus_traits<1u<<16>::is_power_of_two);
+    STATIC_REQUIRE(!fgs::detail::modulus_traits<1237u>::is_pseudo_mersenne);
+    STATIC_REQUIRE(!fgs::detail::modulus_traits<1000000007u>::is_pseudo_mersenne);
+}
+
+TEST_CASE("Specialized reductions match the generic one"){
+    check_against_reference<(1ull<<61)-1>();
+    check_against_reference<(1u<<31)-1>();
+    check_against_reference<18446744073709551557ull>();
+    check_against_reference<1u<<16>();
+    check_against_reference<1ull<<63>();
+    check_against_reference<1000000007u>();
+    check_against_reference<1237>();
+}
+
+TEST_CASE("Reduction edge cases"){
+    using big = fgs::Z<18446744073709551557ull>;
+
+    REQUIRE(big{std::numeric_limits<std::uint64_t>::max()} == 58u);
+    REQUIRE(fgs::Z<1237>{-1237} == 0);
+    REQUIRE(fgs::Z<1237>{std::numeric_limits<std::int64_t>::min()} == 1237 - 9223372036854775807 % 1237 - 1);
+    REQUIRE(--fgs::Z<(1u<<31)-1>{0} == (1u<<31)-2);
+    REQUIRE(++fgs::Z<(1u<<31)-1>{(1u<<31)-2} == 0);
+
+    // Narrow types, which promote to int in any arithmetic
+    REQUIRE(fgs::Z<7>{short(-1)} == 6);
+    REQUIRE(fgs::Z<7>{std::numeric_limits<short>::min()} == 7 - 32768 % 7);
+    REQUIRE(fgs::Z<7>{static_cast<signed char>(-8)} == 6);
+    REQUIRE(fgs::Z<7>{static_cast<signed char>(-128)} == 5);
+    REQUIRE(fgs::Z<7>{'A'} == 65 % 7);
+    REQUIRE(fgs::Z<7>{static_cast<unsigned short>(65535)} == 65535 % 7);
+    REQUIRE(fgs::Z<7>{static_cast<unsigned char>(255)} == 255 % 7);
+    REQUIRE(fgs::Z<8>{short(-1)} == 7);
+    REQUIRE(fgs::Z<1237>{static_cast<signed char>(-1)} == 1236);
+    REQUIRE(big{short(-1)} == 18446744073709551556ull);
+    REQUIRE(big{static_cast<unsigned char>(200)} == 200u);
+
+    REQUIRE(big{"18446744073709551558"} == 1u);
+    REQUIRE(big{"-18446744073709551557"} == 0u);
+    REQUIRE(fgs::Z<(1ull<<61)-1>{"2305843009213693952"} == 1u);
+}
@@ -0,0 +1,145 @@
+#include <catch2/catch.hpp>
+#include "z_module.hpp"
+#include "z_module_sequences.hpp"
+
+#include <array>
+#include <cstdint>
+#include <ranges>
+#include <span>
+#include <vector>
+
+namespace{
+    constexpr auto prime = 998244353u;
+    using zm_t = fgs::Z<prime>;
+
+    // Same recurrence stepped by hand
+    template <auto N>
+    std::vector<fgs::Z<N>> naive_recurrence(const std::vector<fgs::Z<N>> &c,
+                                            const std::vector<fgs::Z<N>> &init, std::size_t n)
+    {
+        std::vector<fgs::Z<N>> a = init;
+        while (a.size() < n){
+            fgs::Z<N> t(0u);
+            for (std::size_t i=0; i<c.size(); ++i)
+                t += c[i] * a[a.size()-1-i];
+            a.push_back(t);
+        }
+        a.resize(n);
+        return a;
+    }
+
+    template <auto N>
+    std::vector<fgs::Z<N>> pseudo_random(std::size_t n, std::uint64_t seed){
+        std::vector<fgs::Z<N>> v(n);
+        for (auto &e : v){
+            seed = seed*6364136223846793005ull + 1442695040888963407ull;
+            e = fgs::Z<N>{seed >> 11};
+        }
+        return v;
+    }
+}
+
+TEST_CASE("Geometric sequences"){
+    STATIC_REQUIRE(std::ranges::view<fgs::geometric_sequence<prime>>);
+    STATIC_REQUIRE(std::ranges::forward_range<fgs::geometric_sequence<prime>>);
+
+    const zm_t g(3u);
+    auto p = fgs::powers(g);
+
+    zm_t expected(1u);
+    for (const auto &e : p | std::views::take(100)){
+        REQUIRE(e == expected);
+        expected *= g;
+    }
+    REQUIRE(p.position() == 0);     // Iterating doesn't consume the generator
+
+    std::vector<zm_t> out(1000);
+    REQUIRE(p.next() == 1);
+    p.next_n(out);
+    for (std::size_t i=0; i<out.size(); ++i)
+        REQUIRE(out[i] == (g ^ (i+1)));
+    REQUIRE(p.position() == 1001);
+    REQUIRE(p.peek() == (g ^ 1001u));
+
+    std::vector<zm_t> small(3);
+    p.next_n(small);
+    REQUIRE(small[2] == (g ^ 1003u));
+    REQUIRE(p.next() == (g ^ 1004u));
+
+    const fgs::geometric_sequence<prime> q(zm_t(5u), zm_t(7u));
+    REQUIRE(q.nth(123456789) == zm_t(5u) * (zm_t(7u) ^ 123456789u));
+    p.seek(1ull << 40);
+    REQUIRE(p.next() == (g ^ (1ull << 40)));
+}
+
+TEST_CASE("Fibonacci numbers"){
+    auto fib = fgs::linear_recurrence(std::array{zm_t(1u), zm_t(1u)}, std::array{zm_t(0u), zm_t(1u)});
+    STATIC_REQUIRE(std::same_as<decltype(fib), fgs::linear_recurrence<prime, 2>>);
+    STATIC_REQUIRE(std::ranges::view<decltype(fib)>);
+
+    const std::array<unsigned, 10> first{0, 1, 1, 2, 3, 5, 8, 13, 21, 34};
+    std::size_t i = 0;
+    for (const auto &e : fib | std::views::take(10))
+        REQUIRE(e == first[i++]);
+
+    // F(90) fits in 64 bits, F(89)+F(88) doesn't need any reduction
+    REQUIRE(fib.nth(90) == zm_t(2880067194370816120ull));
+    REQUIRE(fib.nth(1) == 1);
+
+    // Doubling identities: F(2n) = F(n)*(2F(n+1) - F(n)), F(2n+1) = F(n)^2 + F(n+1)^2
+    const std::uint64_t n = 1000000000000000000ull;
+    const zm_t fn = fib.nth(n), fn1 = fib.nth(n+1);
+    REQUIRE(fib.nth(2*n) == fn*(zm_t(2u)*fn1 - fn));
+    REQUIRE(fib.nth(2*n+1) == fn*fn + fn1*fn1);
+
+    fib.seek(n);
+    REQUIRE(fib.next() == fn);
+    REQUIRE(fib.next() == fn1);
+    REQUIRE(fib.position() == n+2);
+}
+
+TEST_CASE("Linear recurrences match the naive stepping"){
+    for (std::size_t k : {1u, 3u, 17u, 70u, 150u}){
+        const auto c = pseudo_random<prime>(k, k);
+        const auto init = pseudo_random<prime>(k, k+1);
+        const auto expected = naive_recurrence(c, init, 2000);
+
+        fgs::linear_recurrence rec(c, init);
+        STATIC_REQUIRE(std::same_as<decltype(rec), fgs::linear_recurrence<prime>>);
+        REQUIRE(rec.order() == k);
+
+        std::vector<zm_t> out(1000);
+        rec.next_n(out);
+        for (std::size_t i=0; i<out.size(); ++i)
+            REQUIRE(out[i] == expected[i]);
+
+        // The generator goes on after the batch, and batches shorter than
+        // the order take the terms one at a time
+        REQUIRE(rec.position() == 1000);
+        REQUIRE(rec.next() == expected[1000]);
+        rec.next_n(std::span<zm_t>(out).first(k/2));
+        for (std::size_t i=0; i<k/2; ++i)
+            REQUIRE(out[i] == expected[1001+i]);
+        REQUIRE(rec.peek() == expected[1001 + k/2]);
+
+        for (std::uint64_t j : {0ull, 1ull, 500ull, 1999ull})
+            REQUIRE(rec.nth(j) == expected[j]);
+
+        rec.seek(1500);
+        for (std::size_t i=1500; i<2000; ++i)
+            REQUIRE(rec.next() == expected[i]);
+    }
+}
+
+TEST_CASE("Recurrences over composite moduli"){
+    using small_t = fgs::Z<1000>;
+    const std::vector<small_t> c{small_t(2u), small_t(999u), small_t(3u)};
+    const std::vector<small_t> init{small_t(1u), small_t(4u), small_t(9u)};
+    const auto expected = naive_recurrence(c, init, 500);
+
+    fgs::linear_recurrence rec(c, init);
+    for (std::size_t i=0; i<500; ++i){
+        REQUIRE(rec.nth(i) == expected[i]);
+        REQUIRE(rec.next() == expected[i]);
+    }
+}
@@ -0,0 +1,221 @@
+#include <catch2/catch.hpp>
+#include "z_module.hpp"
+#include "z_module_sparse.hpp"
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace{
+    template <auto N>
+    struct random_matrix{
+        using zm_t = fgs::Z<N>;
+        using entry = typename fgs::sparse_zmatrix<N>::entry;
+
+        std::vector<entry> entries;
+        std::vector<std::vector<zm_t>> dense;
+
+        // Rows of very different lengths, some empty, and repeated positions
+        random_matrix(std::size_t rows, std::size_t cols, std::uint64_t seed)
+            : dense(rows, std::vector<zm_t>(cols))
+        {
+            const auto next = [&](){
+                seed = seed*6364136223846793005ull + 1442695040888963407ull;
+                return seed >> 17;
+            };
+            for (std::size_t r=0; r<rows; ++r){
+                const std::size_t length = (r%7 == 3) ? 0 : next() % (1 + 3*(r%5));
+                for (std::size_t i=0; i<length; ++i){
+                    const entry e{r, next() % cols, zm_t(next())};
+                    entries.push_back(e);
+                    dense[r][e.col] += e.value;
+                }
+            }
+        }
+
+        std::vector<zm_t> multiply(const std::vector<zm_t> &x) const {
+            std::vector<zm_t> y(dense.size());
+            for (std::size_t r=0; r<dense.size(); ++r)
+                for (std::size_t c=0; c<x.size(); ++c)
+                    y[r] += dense[r][c] * x[c];
+            return y;
+        }
+    };
+
+    template <auto N>
+    std::vector<fgs::Z<N>> random_vector(std::size_t n, std::uint64_t seed){
+        std::vector<fgs::Z<N>> v(n);
+        for (auto &e : v){
+            seed = seed*6364136223846793005ull + 1442695040888963407ull;
+            e = fgs::Z<N>{seed ^ (seed >> 31)};
+        }
+        return v;
+    }
+
+    template <auto N>
+    void check_products(std::size_t rows, std::size_t cols){
+        using zm_t = fgs::Z<N>;
+        const random_matrix<N> m(rows, cols, rows*cols);
+
+        for (const auto layout : {fgs::sparse_layout::csr, fgs::sparse_layout::ell}){
+            const fgs::sparse_zmatrix<N> a(rows, cols, m.entries, layout);
+            REQUIRE(a.rows() == rows);
+            REQUIRE(a.cols() == cols);
+            REQUIRE(a.layout() == layout);
+
+            const auto x = random_vector<N>(cols, 1);
+            REQUIRE(a * x == m.multiply(x));
+
+            // Blocks of vectors, against the products one by one
+            constexpr std::size_t K = 3;
+            std::vector<std::array<zm_t, K>> xs(cols), ys(rows);
+            std::array<std::vector<zm_t>, K> columns;
+            for (std::size_t k=0; k<K; ++k){
+                columns[k] = random_vector<N>(cols, k+2);
+                for (std::size_t j=0; j<cols; ++j)
+                    xs[j][k] = columns[k][j];
+            }
+            a.template multiply<K>(xs, ys);
+            for (std::size_t k=0; k<K; ++k){
+                const auto y = m.multiply(columns[k]);
+                for (std::size_t r=0; r<rows; ++r)
+                    REQUIRE(ys[r][k] == y[r]);
+            }
+
+            // (A^T y) . x == y . (A x)
+            const auto t = a.transpose();
+            REQUIRE(t.rows() == cols);
+            REQUIRE(t.nonzeros() == a.nonzeros());
+            const auto y = random_vector<N>(rows, 9);
+            const auto ty = t * y, ax = a * x;
+            zm_t lhs(0u), rhs(0u);
+            for (std::size_t j=0; j<cols; ++j)
+                lhs += ty[j] * x[j];
+            for (std::size_t r=0; r<rows; ++r)
+                rhs += y[r] * ax[r];
+            REQUIRE(lhs == rhs);
+        }
+    }
+}
+
+TEST_CASE("Sparse matrix construction"){
+    using zm_t = fgs::Z<7>;
+    using entry = fgs::sparse_zmatrix<7>::entry;
+
+    // Repeated positions are merged, and entries adding up to zero dropped
+    const std::vector<entry> entries{
+        {2, 1, zm_t(3u)}, {0, 2, zm_t(1u)}, {2, 1, zm_t(4u)}, {0, 0, zm_t(5u)}, {2, 0, zm_t(2u)}, {0, 2, zm_t(1u)}
+    };
+    for (const auto layout : {fgs::sparse_layout::csr, fgs::sparse_layout::ell}){
+        const fgs::sparse_zmatrix<7> a(3, 3, entries, layout);
+        REQUIRE(a.nonzeros() == 3);
+        REQUIRE(a.entries() == std::vector<entry>{{0, 0, zm_t(5u)}, {0, 2, zm_t(2u)}, {2, 0, zm_t(2u)}});
+        REQUIRE(a * std::vector<zm_t>{zm_t(1u), zm_t(1u), zm_t(1u)} == std::vector<zm_t>{zm_t(0u), zm_t(0u), zm_t(2u)});
+    }
+
+    const fgs::sparse_zmatrix<7> empty(4, 5, {});
+    REQUIRE(empty.nonzeros() == 0);
+    REQUIRE(empty * std::vector<zm_t>(5, zm_t(1u)) == std::vector<zm_t>(4));
+    for (const auto layout : {fgs::sparse_layout::csr, fgs::sparse_layout::ell}){
+        const fgs::sparse_zmatrix<7> zero(3, 3, {}, layout);
+        std::vector<zm_t> y(3, zm_t(4u));
+        zero.multiply(std::vector<zm_t>(3, zm_t(1u)), y);
+        REQUIRE(y == std::vector<zm_t>(3));
+    }
+
+#ifdef FGS_EXCEPTIONS_SUPPORT
+    const std::vector<entry> wrong{{3, 0, zm_t(1u)}};
+    REQUIRE_THROWS_AS(fgs::sparse_zmatrix<7>(3, 3, wrong), std::out_of_range);
+#endif
+}
+
+TEST_CASE("Sparse matrix-vector products"){
+    check_products<97>(50, 40);
+    check_products<998244353u>(200, 150);
+    check_products<(1ull << 61) - 1>(120, 130);
+    check_products<18446744073709551557ull>(100, 100);  // A reduction per product
+    check_products<65536u>(80, 80);                     // Almost never reduced
+
+    // Big enough to be split among threads
+    constexpr auto N = 998244353u;
+    const std::size_t n = 1 << 17;
+    std::vector<fgs::sparse_zmatrix<N>::entry> entries;
+    for (std::size_t r=0; r<n; ++r){
+        entries.push_back({r, r, fgs::Z<N>(r+1)});
+        entries.push_back({r, (r*7919) % n, fgs::Z<N>(3u)});
+    }
+    const fgs::sparse_zmatrix<N> a(n, n, entries);
+    const auto x = random_vector<N>(n, 5);
+    const auto y = a * x;
+    for (std::size_t r=0; r<n; ++r){
+        const auto expected = (r == (r*7919) % n) ? x[r] * (r+4) : x[r] * (r+1) + x[(r*7919) % n] * 3;
+        REQUIRE(y[r] == expected);
+    }
+}
+
+TEST_CASE("Berlekamp-Massey"){
+    using zm_t = fgs::Z<998244353u>;
+
+    // Fibonacci
+    std::vector<zm_t> fib{zm_t(0u), zm_t(1u)};
+    for (int i=2; i<20; ++i)
+        fib.push_back(fib[fib.size()-1] + fib[fib.size()-2]);
+    REQUIRE(fgs::berlekamp_massey<998244353u>(fib) == std::vector<zm_t>{zm_t(1u), zm_t(1u)});
+
+    // A random recurrence of order k, from 2k terms
+    const std::size_t k = 40;
+    const auto c = random_vector<998244353u>(k, 1), init = random_vector<998244353u>(k, 2);
+    fgs::linear_recurrence rec(c, init);
+    std::vector<zm_t> s(2*k);
+    rec.next_n(s);
+    const auto found = fgs::berlekamp_massey<998244353u>(s);
+    REQUIRE(found == c);
+
+    // Degenerate sequences
+    REQUIRE(fgs::berlekamp_massey<998244353u>(std::vector<zm_t>(10)).empty());
+    REQUIRE(fgs::berlekamp_massey<998244353u>(std::vector<zm_t>{}).empty());
+    REQUIRE(fgs::berlekamp_massey<998244353u>(std::vector<zm_t>{zm_t(0u), zm_t(0u), zm_t(5u)}).size() == 3);
+}
+
+TEST_CASE("Minimal polynomial of sparse matrices"){
+    constexpr auto P = 998244353u;
+    using zm_t = fgs::Z<P>;
+    using poly = fgs::polynomial<P>;
+    using entry = fgs::sparse_zmatrix<P>::entry;
+
+    // Diagonal with repeated values: the minimal polynomial only has each root once
+    std::vector<entry> diagonal;
+    const std::array<unsigned, 4> values{2, 3, 5, 3};
+    for (std::size_t i=0; i<20; ++i)
+        diagonal.push_back({i, i, zm_t(values[i%4])});
+    const fgs::sparse_zmatrix<P> d(20, 20, diagonal);
+    REQUIRE(fgs::minimal_polynomial(d) == poly{zm_t(-2), zm_t(1u)} * poly{zm_t(-3), zm_t(1u)} * poly{zm_t(-5), zm_t(1u)});
+
+    // Nilpotent shift: x^n
+    std::vector<entry> shift;
+    for (std::size_t i=0; i+1<30; ++i)
+        shift.push_back({i+1, i, zm_t(1u)});
+    const auto m = fgs::minimal_polynomial(fgs::sparse_zmatrix<P>(30, 30, shift));
+    REQUIRE(m.degree() == 30);
+    REQUIRE(m[30] == 1);
+    for (std::size_t i=0; i<30; ++i)
+        REQUIRE(m[i] == 0);
+
+    // Zero matrix: x
+    REQUIRE(fgs::minimal_polynomial(fgs::sparse_zmatrix<P>(10, 10, {})) == poly{zm_t(0u), zm_t(1u)});
+    REQUIRE(fgs::minimal_polynomial(fgs::sparse_zmatrix<P>(10, 10, {}, fgs::sparse_layout::ell)) == poly{zm_t(0u), zm_t(1u)});
+
+    // Random matrix: m(A) v = 0
+    const std::size_t n = 60;
+    const random_matrix<P> r(n, n, 3);
+    const fgs::sparse_zmatrix<P> a(n, n, r.entries, fgs::sparse_layout::ell);
+    const auto f = fgs::minimal_polynomial(a, 12345);
+    auto v = random_vector<P>(n, 7);
+    std::vector<zm_t> acc(n);
+    for (std::size_t i=0; i<f.size(); ++i){
+        for (std::size_t j=0; j<n; ++j)
+            acc[j] += f[i] * v[j];
+        v = a * v;
+    }
+    REQUIRE(acc == std::vector<zm_t>(n));
+}
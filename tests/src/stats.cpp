@@ -0,0 +1,128 @@
+#include <catch2/catch.hpp>
+#include "z_module.hpp"
+#include "z_module_stats.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+
+// This file is built with FGS_STATS_SUPPORT in its own test executable
+TEST_CASE("Operation counters"){
+    using zm_t = fgs::Z<1237>;
+    fgs::stats::reset();
+
+    zm_t a{-10}, b{2000};       // 2 reductions
+    a += b; a -= b; a *= b;     // add, sub, mul
+    a = a/b;                    // div + inverse
+    a = a ^ 100;                // pow (and the multiplications inside)
+    a = zm_t{"123456789"};      // parse
+    ++a; --a;
+
+    // Other threads are aggregated too, even after they finish
+    std::thread{[]{ fgs::Z<1237> c{1}, d{2}; c += d; c += d; }}.join();
+
+    const auto report = fgs::stats::snapshot();
+    if constexpr (!fgs::stats::enabled){
+        REQUIRE(report.moduli.empty());
+        return;
+    }
+
+    const auto *s = report.find(1237);
+    REQUIRE(s != nullptr);
+    REQUIRE(s->count(fgs::stats::operation::add) == 4);
+    REQUIRE(s->count(fgs::stats::operation::sub) == 2);
+    REQUIRE(s->count(fgs::stats::operation::div) == 1);
+    REQUIRE(s->count(fgs::stats::operation::inverse) == 1);
+    REQUIRE(s->count(fgs::stats::operation::pow) == 1);
+    REQUIRE(s->count(fgs::stats::operation::parse) == 1);
+    REQUIRE(s->count(fgs::stats::operation::mul) > 1);
+    REQUIRE(s->count(fgs::stats::operation::reduce) >= 2);
+
+    const std::string json = report.to_json();
+    REQUIRE(json.find("\"modulus\":1237") != std::string::npos);
+    REQUIRE(json.find("\"inverse\":1") != std::string::npos);
+
+    fgs::stats::reset();
+    REQUIRE(fgs::stats::snapshot().find(1237)->count(fgs::stats::operation::add) == 0);
+}
+
+TEST_CASE("Reductions of mixed operations"){
+    using zm_t = fgs::Z<1237>;
+    zm_t a{1u};
+
+    const auto reductions = [](){
+        const auto report = fgs::stats::snapshot();
+        const auto *s = report.find(1237);
+        return (s == nullptr) ? 0 : s->count(fgs::stats::operation::reduce);
+    };
+    fgs::stats::reset();
+
+    // Operands already in [0, N) aren't reduced, the rest are
+    a += 5ull;
+    a *= static_cast<unsigned char>(200);
+    a -= 3;
+    REQUIRE(reductions() == 0);
+    a += 5000ull;
+    a *= -3;
+    REQUIRE(reductions() == (fgs::stats::enabled ? 2 : 0));
+    REQUIRE(a == (((1 + 5) * 200 - 3 + 5000) * -3) % 1237 + 1237);
+
+    // Constructing the z-module first counts the same reductions
+    for (const long long k : {7LL, 1236LL, 1237LL, -1LL, 123456789LL}){
+        fgs::stats::reset();
+        const auto lhs = zm_t{k} * a;
+        const auto constructed = reductions();
+        fgs::stats::reset();
+        const auto rhs = a * k;
+        REQUIRE(reductions() == constructed);
+        REQUIRE(lhs == rhs);
+        REQUIRE(constructed == ((fgs::stats::enabled && (k < 0 || k >= 1237)) ? 1 : 0));
+    }
+
+    // Powers of two only mask, which never counts as a reduction
+    using two_t = fgs::Z<1024u>;
+    const two_t b{3u};
+    const auto masks = [](){
+        const auto report = fgs::stats::snapshot();
+        const auto *s = report.find(1024);
+        return (s == nullptr) ? 0 : s->count(fgs::stats::operation::reduce);
+    };
+    for (const long long k : {7LL, 1023LL, 1024LL, -1LL, 123456789LL}){
+        fgs::stats::reset();
+        const auto lhs = two_t{k} * b;
+        const auto rhs = b * k;
+        REQUIRE(masks() == 0);
+        REQUIRE(lhs == rhs);
+        REQUIRE(rhs == two_t{static_cast<unsigned>(k & 1023) * 3u});
+    }
+}
+
+TEST_CASE("Resets while other threads count"){
+    std::atomic<bool> stop{false};
+    std::atomic<std::uint64_t> performed{0};
+    std::thread worker{[&]{
+        fgs::Z<4099> c{1}, d{2};
+        while (!stop.load()){
+            c += d;
+            performed.fetch_add(1);
+        }
+    }};
+
+    // Only the additions after a reset can be reported (plus the one that
+    // may be between its counter and performed). A reset lost in the
+    // middle of an update would bring back the whole count
+    for (int i=0; i<1000; ++i){
+        const auto before = performed.load();
+        fgs::stats::reset();
+        const auto report = fgs::stats::snapshot();
+        const auto after = performed.load();
+
+        const auto *s = report.find(4099);
+        const std::uint64_t added = (s == nullptr) ? 0 : s->count(fgs::stats::operation::add);
+        REQUIRE(added <= after - before + 1);
+    }
+
+    stop = true;
+    worker.join();
+}